@@ -0,0 +1,218 @@
+#include "Core/Core.h"
+#include "Core/Log.h"
+#include "Core/Timer.h"
+#include "Math/Math.h"
+#include "Math/Matrix4.h"
+#include "Math/Random.h"
+#include "Math/SIMD.h"
+#include "Math/Vector2.h"
+#include "Math/Vector3.h"
+#include "Math/Vector4.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+static constexpr uint64 NumberOfOperations = 4096;
+static constexpr uint32 NumberOfRuns = 50;
+
+// Matrix4 compiles only its SIMD paths on x86-64, these are its scalar fallbacks to compare against
+
+static Matrix4 MultiplyScalar(const Matrix4& a, const Matrix4& b)
+{
+	Matrix4 result;
+	for (int i = 0; i < 4; i++)
+	{
+		result.M[i] = a.M[0] * b.M[i].Data[0] + a.M[1] * b.M[i].Data[1] + a.M[2] * b.M[i].Data[2] + a.M[3] * b.M[i].Data[3];
+	}
+
+	return result;
+}
+
+static Vector4 MultiplyScalar(const Matrix4& m, const Vector4& v)
+{
+	return (m.M[0] * Vector4(v.Data[0]) + m.M[1] * Vector4(v.Data[1])) + (m.M[2] * Vector4(v.Data[2]) + m.M[3] * Vector4(v.Data[3]));
+}
+
+// Gauss-Jordan elimination with full pivoting
+static Matrix4 InverseScalar(const Matrix4& m)
+{
+	int indxc[4], indxr[4];
+	int ipiv[4] = { 0, 0, 0, 0 };
+	float minv[4][4];
+
+	for (int s = 0; s < 4; s++)
+	{
+		for (int t = 0; t < 4; t++) minv[s][t] = m.V[s][t];
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		int irow = -1, icol = -1;
+		float big = 0.0f;
+
+		for (int j = 0; j < 4; j++)
+		{
+			if (ipiv[j] == 1) continue;
+
+			for (int k = 0; k < 4; k++)
+			{
+				if (ipiv[k] == 0 && std::abs(minv[j][k]) >= big)
+				{
+					big = std::abs(minv[j][k]);
+					irow = j;
+					icol = k;
+				}
+			}
+		}
+		++ipiv[icol];
+
+		if (irow != icol)
+		{
+			for (int k = 0; k < 4; k++) std::swap(minv[irow][k], minv[icol][k]);
+		}
+		indxr[i] = irow;
+		indxc[i] = icol;
+
+		const float pivinv = 1.0f / minv[icol][icol];
+		minv[icol][icol] = 1.0f;
+		for (int j = 0; j < 4; j++) minv[icol][j] *= pivinv;
+
+		for (int j = 0; j < 4; j++)
+		{
+			if (j == icol) continue;
+
+			const float save = minv[j][icol];
+			minv[j][icol] = 0.0f;
+			for (int k = 0; k < 4; k++) minv[j][k] -= minv[icol][k] * save;
+		}
+	}
+
+	for (int j = 3; j >= 0; j--)
+	{
+		if (indxr[j] == indxc[j]) continue;
+
+		for (int k = 0; k < 4; k++) std::swap(minv[k][indxr[j]], minv[k][indxc[j]]);
+	}
+
+	return Matrix4(minv);
+}
+
+static void TransformPointsScalar(const Matrix4& matrix, const Vector2* in, Vector4* out, uint64 count)
+{
+	for (uint64 i = 0; i < count; i++)
+	{
+		for (int j = 0; j < 4; j++) out[i].Data[j] = matrix.V[0][j] * in[i].X + matrix.V[1][j] * in[i].Y + matrix.V[3][j];
+	}
+}
+
+// Best of NumberOfRuns, in nanoseconds per operation
+template <typename F>
+static float Measure(const F& function)
+{
+	float best = FLT_MAX;
+
+	for (uint32 run = 0; run < NumberOfRuns; run++)
+	{
+		Timer timer;
+		function();
+		best = std::min(best, timer.GetElapsedMilliseconds());
+	}
+
+	return best * 1000000.0f / NumberOfOperations;
+}
+
+static float MaxDifference(const Vector4& a, const Vector4& b)
+{
+	float difference = 0.0f;
+	for (int i = 0; i < 4; i++) difference = std::max(difference, std::abs(a.Data[i] - b.Data[i]));
+
+	return difference;
+}
+
+static float MaxDifference(const Matrix4& a, const Matrix4& b)
+{
+	float difference = 0.0f;
+	for (int i = 0; i < 4; i++) difference = std::max(difference, MaxDifference(a.M[i], b.M[i]));
+
+	return difference;
+}
+
+static void Report(const char* name, float scalar, float simd, float difference)
+{
+	GARBAGE_INFO("{:<18} scalar {:6.2f} ns | SIMD {:6.2f} ns | {:4.1f}x | max difference {}", name, scalar, simd, scalar / simd, difference);
+}
+
+int main()
+{
+	GarbageEngine2D::Init();
+
+	Random random(1234);
+
+	// Random affine transforms, so every matrix has an inverse
+	std::vector<Matrix4> matrices(NumberOfOperations);
+	std::vector<Matrix4> others(NumberOfOperations);
+	std::vector<Vector4> vectors(NumberOfOperations);
+	std::vector<Vector2> points(NumberOfOperations);
+
+	for (uint64 i = 0; i < NumberOfOperations; i++)
+	{
+		matrices[i] = Matrix4::Identity.Translate(Vector3(random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), random.NextFloat(-1.0f, 1.0f)))
+			.RotateZ(random.NextFloat(0.0f, Math::Pi * 2.0f)).Scale(Vector3(random.NextFloat(0.1f, 10.0f), random.NextFloat(0.1f, 10.0f), 1.0f));
+		others[i] = Matrix4::Identity.Translate(Vector3(random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), 0.0f))
+			.RotateZ(random.NextFloat(0.0f, Math::Pi * 2.0f));
+		vectors[i] = Vector4(random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f), 0.0f, 1.0f);
+		points[i] = Vector2(random.NextFloat(-100.0f, 100.0f), random.NextFloat(-100.0f, 100.0f));
+	}
+
+	std::vector<Matrix4> scalarMatrices(NumberOfOperations);
+	std::vector<Matrix4> simdMatrices(NumberOfOperations);
+	std::vector<Vector4> scalarVectors(NumberOfOperations);
+	std::vector<Vector4> simdVectors(NumberOfOperations);
+
+	GARBAGE_INFO("{} operations, best of {} runs, AVX2 {}", NumberOfOperations, NumberOfRuns, SIMD::IsAVX2Supported() ? "supported" : "not supported");
+
+	{
+		const float scalar = Measure([&]() { for (uint64 i = 0; i < NumberOfOperations; i++) scalarMatrices[i] = MultiplyScalar(matrices[i], others[i]); });
+		const float simd = Measure([&]() { for (uint64 i = 0; i < NumberOfOperations; i++) simdMatrices[i] = matrices[i] * others[i]; });
+
+		float difference = 0.0f;
+		for (uint64 i = 0; i < NumberOfOperations; i++) difference = std::max(difference, MaxDifference(scalarMatrices[i], simdMatrices[i]));
+
+		Report("Matrix4 * Matrix4", scalar, simd, difference);
+	}
+
+	{
+		const float scalar = Measure([&]() { for (uint64 i = 0; i < NumberOfOperations; i++) scalarVectors[i] = MultiplyScalar(matrices[i], vectors[i]); });
+		const float simd = Measure([&]() { for (uint64 i = 0; i < NumberOfOperations; i++) simdVectors[i] = matrices[i] * vectors[i]; });
+
+		float difference = 0.0f;
+		for (uint64 i = 0; i < NumberOfOperations; i++) difference = std::max(difference, MaxDifference(scalarVectors[i], simdVectors[i]));
+
+		Report("Matrix4 * Vector4", scalar, simd, difference);
+	}
+
+	{
+		const float scalar = Measure([&]() { for (uint64 i = 0; i < NumberOfOperations; i++) scalarMatrices[i] = InverseScalar(matrices[i]); });
+		const float simd = Measure([&]() { for (uint64 i = 0; i < NumberOfOperations; i++) simdMatrices[i] = matrices[i].Inverse(); });
+
+		float difference = 0.0f;
+		for (uint64 i = 0; i < NumberOfOperations; i++) difference = std::max(difference, MaxDifference(scalarMatrices[i], simdMatrices[i]));
+
+		Report("Inverse", scalar, simd, difference);
+	}
+
+	{
+		const float scalar = Measure([&]() { TransformPointsScalar(matrices[0], points.data(), scalarVectors.data(), NumberOfOperations); });
+		const float simd = Measure([&]() { TransformPoints(matrices[0], points.data(), simdVectors.data(), NumberOfOperations); });
+
+		float difference = 0.0f;
+		for (uint64 i = 0; i < NumberOfOperations; i++) difference = std::max(difference, MaxDifference(scalarVectors[i], simdVectors[i]));
+
+		Report("TransformPoints", scalar, simd, difference);
+	}
+
+	GarbageEngine2D::Shutdown();
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+project "MathBenchmark"
+    kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+
+	targetdir ("%{wks.location}/Bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/Intermediate/" .. outputdir .. "/%{prj.name}")
+
+    flags { "NoPCH" }
+
+	files
+	{
+		"Source/**.h",
+		"Source/**.cpp"
+	}
+
+	defines
+	{
+		"_CRT_SECURE_NO_WARNINGS"
+	}
+
+	includedirs
+	{
+		"%{Include.spdlog}",
+        "%{wks.location}/GarbageEngine2D/Source/Public",
+        "%{wks.location}/GarbageEngine2D/Source/Intermediate"
+	}
+
+	links
+	{
+		"spdlog",
+		"GarbageEngine2D"
+	}
+
+	postbuildcommands
+	{
+		"{COPY} %{wks.location}Bin/" .. outputdir .. "/GarbageEngine2D/*.dll %{wks.location}Bin/" .. outputdir .. "/%{prj.name}",
+		"{COPY} %{wks.location}Bin/" .. outputdir .. "/GarbageEngine2D/*.so %{wks.location}Bin/" .. outputdir .. "/%{prj.name}"
+	}
+	
+	disablewarnings { "4251", "4005" }
+	
+	filter "system:windows"
+		systemversion "latest"
+
+		links
+		{
+			"%{Library.WinSock}",
+			"%{Library.WinMM}",
+			"%{Library.WinVersion}",
+			"%{Library.BCrypt}"
+		}
+
+	filter "configurations:Debug"
+		defines
+        {
+            "GARBAGE_DEBUG",
+            "_DEBUG",
+			"GARBAGE_ENGINE_DLL"
+        }
+
+		runtime "Debug"
+		symbols "on"
+        staticruntime "off"
+
+	filter "configurations:Release"
+		defines 
+        {
+            "GARBAGE_RELEASE",
+            "NDEBUG",
+			"GARBAGE_ENGINE_DLL"
+        }
+
+		runtime "Release"
+		optimize "Speed"
+        staticruntime "off"
+
+	filter "configurations:Shipping"
+		defines "GARBAGE_SHIPPING"
+		runtime "Release"
+		optimize "Speed"
+        staticruntime "off"
@@ -0,0 +1,23 @@
+#include "Core/Core.h"
+#include "Core/Log.h"
+#include "Core/Registry.h"
+#include "Core/Timer.h"
+#include "ReflectionBenchmarkReflection.h"
+
+// The registry can be filled only once per process, run the executable several times to get stable numbers
+int main()
+{
+	GarbageEngine2D::Init();
+
+	const uint64 numberOfEngineTypes = Meta::Registry::Get().GetAllTypes().size();
+
+	Timer timer;
+	ReflectionBenchmarkReflection::Register();
+	const float milliseconds = timer.GetElapsedMilliseconds();
+
+	GARBAGE_INFO("Registered {} types in {} ms", Meta::Registry::Get().GetAllTypes().size() - numberOfEngineTypes, milliseconds);
+
+	GarbageEngine2D::Shutdown();
+
+	return 0;
+}
\ No newline at end of file
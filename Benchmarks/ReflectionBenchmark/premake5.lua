@@ -0,0 +1,155 @@
+-- Measures startup registration of 1000 synthetic GCLASS types. The same types are built twice,
+-- registered step by step and registered from the static tables of GarbageHeaderTool -static
+
+local NumberOfSyntheticHeaders = 100
+local SyntheticTypesPerHeader = 10
+
+local function SyntheticName(index)
+    return string.format("SyntheticType%04d", index)
+end
+
+-- Every header holds a chain of types derived from ObjectBase. Unchanged headers are not rewritten, so the header tool skips them
+local function GenerateSyntheticTypes(path)
+    os.mkdir(path)
+
+    for header = 0, NumberOfSyntheticHeaders - 1 do
+        local first = header * SyntheticTypesPerHeader
+        local lines =
+        {
+            "#pragma once",
+            "",
+            "#include \"Core/Base.h\"",
+            "#include \"Core/Registry.h\"",
+            "#include \"Math/Vector3.h\"",
+            "#include \"" .. SyntheticName(first) .. ".generated.h\"",
+            ""
+        }
+
+        for index = first, first + SyntheticTypesPerHeader - 1 do
+            local parent = index == first and "ObjectBase" or SyntheticName(index - 1)
+
+            table.insert(lines, "GCLASS();")
+            table.insert(lines, "class " .. SyntheticName(index) .. " : public " .. parent)
+            table.insert(lines, "{")
+            table.insert(lines, "\tGENERATED_BODY()")
+            table.insert(lines, "")
+            table.insert(lines, "public:")
+            table.insert(lines, "")
+            table.insert(lines, "\tGPROPERTY();")
+            table.insert(lines, "\tfloat Speed;")
+            table.insert(lines, "\tGPROPERTY();")
+            table.insert(lines, "\tint32 Count;")
+            table.insert(lines, "\tGPROPERTY();")
+            table.insert(lines, "\tVector3 Position;")
+            table.insert(lines, "")
+            table.insert(lines, "};")
+            table.insert(lines, "")
+        end
+
+        local file = path .. "/" .. SyntheticName(first) .. ".h"
+        local content = table.concat(lines, "\n")
+
+        if io.readfile(file) ~= content then io.writefile(file, content) end
+    end
+end
+
+GenerateSyntheticTypes(path.getabsolute("Source/Synthetic"))
+
+local function ReflectionBenchmarkProject(name, mode, headerToolFlags)
+    project(name)
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+
+        targetdir ("%{wks.location}/Bin/" .. outputdir .. "/%{prj.name}")
+        objdir ("%{wks.location}/Intermediate/" .. outputdir .. "/%{prj.name}")
+
+        flags { "NoPCH" }
+
+        files
+        {
+            "Source/Private/**.cpp",
+            "Source/Synthetic/**.h",
+            "Source/Intermediate/" .. mode .. "/**.h"
+        }
+
+        defines
+        {
+            "_CRT_SECURE_NO_WARNINGS"
+        }
+
+        includedirs
+        {
+            "Source/Synthetic",
+            "Source/Intermediate/" .. mode,
+            "%{Include.spdlog}",
+            "%{wks.location}/GarbageEngine2D/Source/Public",
+            "%{wks.location}/GarbageEngine2D/Source/Intermediate"
+        }
+
+        links
+        {
+            "spdlog",
+            "GarbageEngine2D"
+        }
+
+        -- Both projects use one project name, so the generated code differs only by the registration mode
+        prebuildcommands
+        {
+            "%{wks.location}Bin/" .. outputdir .. "/GarbageHeaderTool/GarbageHeaderTool -pReflectionBenchmark -aNO_API -s%{prj.location}Source/Synthetic -o%{prj.location}Source/Intermediate/" .. mode .. headerToolFlags
+        }
+
+        postbuildcommands
+        {
+            "{COPY} %{wks.location}Bin/" .. outputdir .. "/GarbageEngine2D/*.dll %{wks.location}Bin/" .. outputdir .. "/%{prj.name}",
+            "{COPY} %{wks.location}Bin/" .. outputdir .. "/GarbageEngine2D/*.so %{wks.location}Bin/" .. outputdir .. "/%{prj.name}"
+        }
+
+        disablewarnings { "4251", "4005" }
+
+        filter "system:windows"
+            systemversion "latest"
+
+            links
+            {
+                "%{Library.WinSock}",
+                "%{Library.WinMM}",
+                "%{Library.WinVersion}",
+                "%{Library.BCrypt}"
+            }
+
+        filter "configurations:Debug"
+            defines
+            {
+                "GARBAGE_DEBUG",
+                "_DEBUG",
+                "GARBAGE_ENGINE_DLL"
+            }
+
+            runtime "Debug"
+            symbols "on"
+            staticruntime "off"
+
+        filter "configurations:Release"
+            defines
+            {
+                "GARBAGE_RELEASE",
+                "NDEBUG",
+                "GARBAGE_ENGINE_DLL"
+            }
+
+            runtime "Release"
+            optimize "Speed"
+            staticruntime "off"
+
+        filter "configurations:Shipping"
+            defines "GARBAGE_SHIPPING"
+            runtime "Release"
+            optimize "Speed"
+            staticruntime "off"
+
+        filter {}
+end
+
+ReflectionBenchmarkProject("ReflectionBenchmarkDynamic", "Dynamic", "")
+ReflectionBenchmarkProject("ReflectionBenchmarkStatic", "Static", " -static")
\ No newline at end of file
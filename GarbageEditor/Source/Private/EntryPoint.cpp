@@ -1,4 +1,5 @@
 #include "Editor/Core.h"
+#include "Core/Core.h"
 #include "Math/Vector2.h"
 #include "Rendering/Window.h"
 #include "Rendering/Renderer.h"
@@ -6,11 +7,13 @@
 #include "Core/Utils.h"
 #include "Core/Asset/AssetManager.h"
 #include "Memory/Statistics.h"
+#include "Core/Profiling.h"
 #include <Core/Asset/Texture2D.h>
 #include <Rendering/Texture.h>
 #include <Rendering/Shader.h>
 #include <Math/Random.h>
 #include <unordered_set>
+#include <iterator>
 #include <portable-file-dialogs.h>
 
 int main()
@@ -87,6 +90,15 @@ int main()
 	{
 		window.PollEvents();
 
+		// F12 starts a profiler capture and saves it when pressed again
+		if (window.IsKeyDown(KeyCode::F12))
+		{
+			Profiler::SetEnabled(!Profiler::IsEnabled());
+
+			if (Profiler::IsEnabled()) Profiler::Clear();
+			else Profiler::ExportChromeTrace("ProfilerCapture.json");
+		}
+
 		const float aspect = window.GetFramebufferSize().X / window.GetFramebufferSize().Y;
 
 		const Matrix4 projection = Matrix4::Ortho(-4.0f * aspect, 4.0f * aspect, -4.0f, 4.0f, -1.0f, 1.0f);
@@ -105,10 +117,16 @@ int main()
 		renderer.EndFrame();
 
 		auto stats = renderer.GetStatistics();
-		window.SetTitle(std::to_string(stats.DrawCalls) + " draw call(s) | " + std::to_string(stats.TotalNumberOfVertices) + " vertices | " + std::to_string(stats.FrameTime) + "ms");
+		FrameString title(renderer.GetFrameAllocator());
+		auto frameTime = renderer.GetFrameSummary(Renderer::FrameMetric::FrameTime);
+		fmt::format_to(std::back_inserter(title), "{} draw call(s) | {} vertices | {:.2f}ms | avg {:.2f}ms | p99 {:.2f}ms | GPU {:.2f}ms",
+			stats.DrawCalls, stats.TotalNumberOfVertices, stats.FrameTime, frameTime.Average, frameTime.P99, stats.GpuTime);
+		window.SetTitle(title);
 
 		window.SwapBuffers();
 	}
 
+	GarbageEngine2D::Shutdown();
+
 	return 0;
 }
\ No newline at end of file
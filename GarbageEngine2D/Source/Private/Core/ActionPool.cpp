@@ -0,0 +1,97 @@
+#include "Core/ActionPool.h"
+
+ActionPool::ActionPool(uint32 capacity) : m_nodes(new Node[capacity]), m_capacity(capacity)
+{
+	for (uint32 i = 0; i < capacity; i++)
+	{
+		m_nodes[i].Index = i;
+		m_nodes[i].NextFree.store(i + 1 < capacity ? i + 2 : 0, std::memory_order_relaxed);
+	}
+
+	m_freeNodes.store(capacity > 0 ? 1 : 0, std::memory_order_relaxed);
+}
+
+ActionPool::~ActionPool()
+{
+	for (Node* node = m_head.exchange(nullptr, std::memory_order_acquire); node;)
+	{
+		Node* next = node->Next;
+		if (node->Index == HeapNode) delete node;
+
+		node = next;
+	}
+}
+
+void ActionPool::AddAction(Action action)
+{
+	Node* node = AllocateNode();
+	node->Function = std::move(action);
+
+	Node* head = m_head.load(std::memory_order_relaxed);
+
+	do
+	{
+		node->Next = head;
+	} while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ActionPool::Execute()
+{
+	Node* node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+	// The batch is a stack, reverse it to run actions in the order they were added
+	Node* ordered = nullptr;
+	while (node)
+	{
+		Node* next = node->Next;
+		node->Next = ordered;
+		ordered = node;
+		node = next;
+	}
+
+	while (ordered)
+	{
+		Node* next = ordered->Next;
+
+		ordered->Function();
+		ordered->Function = nullptr;
+		FreeNode(ordered);
+
+		ordered = next;
+	}
+}
+
+ActionPool::Node* ActionPool::AllocateNode()
+{
+	uint64 freeNodes = m_freeNodes.load(std::memory_order_acquire);
+
+	while (uint32 first = (uint32)freeNodes)
+	{
+		Node& node = m_nodes[first - 1];
+
+		const uint64 tag = (freeNodes >> 32) + 1;
+		const uint64 next = (tag << 32) | node.NextFree.load(std::memory_order_relaxed);
+
+		if (m_freeNodes.compare_exchange_weak(freeNodes, next, std::memory_order_acquire, std::memory_order_acquire)) return &node;
+	}
+
+	return new Node();
+}
+
+void ActionPool::FreeNode(Node* node)
+{
+	if (node->Index == HeapNode)
+	{
+		delete node;
+		return;
+	}
+
+	uint64 freeNodes = m_freeNodes.load(std::memory_order_relaxed);
+	uint64 next;
+
+	do
+	{
+		node->NextFree.store((uint32)freeNodes, std::memory_order_relaxed);
+		next = (((freeNodes >> 32) + 1) << 32) | (node->Index + 1);
+	} while (!m_freeNodes.compare_exchange_weak(freeNodes, next, std::memory_order_release, std::memory_order_relaxed));
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Core/Asset/AssetManager.h"
 #include "Core/Asset/Asset.h"
+#include "Core/JobSystem.h"
+#include "Core/Profiling.h"
 #include "Core/Registry.h"
 #include <algorithm>
 #include <cctype>
@@ -36,9 +38,9 @@ void AssetManager::GatherAssetFactories()
 
 	for (auto& type : Meta::Registry::Get().GetAllTypes())
 	{
-		if (type->HasParent(parentType))
+		if (type != parentType && type->IsDerivedFrom(parentType))
 		{
-			GARBAGE_CORE_ASSERT(type->HasDecorator("AssetType"));
+			GARBAGE_CORE_ASSERT(type->HasDecorator(GARBAGE_SID("AssetType")));
 
 			m_factories.emplace_back((AssetFactory*)type->Construct(&m_allocator));
 			GARBAGE_CORE_TRACE("Found asset factory: {}", type->GetName());
@@ -55,6 +57,8 @@ void AssetManager::Init(Ref<FileSystem> fileSystem)
 
 Ref<Asset> AssetManager::LoadAsset(const std::filesystem::path& name)
 {
+	GARBAGE_CORE_PROFILE_FUNCTION();
+
 	std::string extension;
 	if (!StripFileExtension(name, extension)) return nullptr;
 
@@ -82,19 +86,22 @@ Ref<Asset> AssetManager::LoadAsset(const std::filesystem::path& name)
 	{
 		auto type = factory->GetType();
 
-		if (type->HasDecorator("ConvertedFormat"))
+		if (type->HasDecorator(GARBAGE_SID("ConvertedFormat")))
 		{
-			auto convertedFileExtensions = type->GetDecoratorValues("ConvertedFormat");
+			auto convertedFileExtensions = type->GetDecoratorValues(GARBAGE_SID("ConvertedFormat"));
 
-			for (auto& format : *convertedFileExtensions)
+			for (auto& format : convertedFileExtensions)
 			{
 				if (format == extension)
 				{
-					auto instance = (AssetFactory*)type->Construct(nullptr);
+					auto instance = (AssetFactory*)type->Construct();
+
+					Ref<Asset> asset = Ref<Asset>((Asset*)Meta::Registry::Get().FindType(type->GetDecoratorValues(GARBAGE_SID("AssetType"))[0])->Construct(nullptr));
 
-					Ref<Asset> asset = Ref<Asset>((Asset*)Meta::Registry::Get().FindType((*type->GetDecoratorValues("AssetType"))[0])->Construct(nullptr));
+					const bool deserialized = instance->Deserialize(asset.get(), file.get());
+					type->Destroy(instance);
 
-					if (instance->Deserialize(asset.get(), file.get()))
+					if (deserialized)
 					{
 						asset->m_name = name.filename();
 						asset->m_sourcePath = sourcePath;
@@ -106,19 +113,22 @@ Ref<Asset> AssetManager::LoadAsset(const std::filesystem::path& name)
 			}
 		}
 
-		if (type->HasDecorator("SourceFileFormats"))
+		if (type->HasDecorator(GARBAGE_SID("SourceFileFormats")))
 		{
-			auto sourceFileExtensions = type->GetDecoratorValues("SourceFileFormats");
+			auto sourceFileExtensions = type->GetDecoratorValues(GARBAGE_SID("SourceFileFormats"));
 
-			for (auto& format : *sourceFileExtensions)
+			for (auto& format : sourceFileExtensions)
 			{
 				if (format == extension)
 				{
-					auto instance = (AssetFactory*)type->Construct(nullptr);
+					auto instance = (AssetFactory*)type->Construct();
+
+					Ref<Asset> asset = Ref<Asset>((Asset*)Meta::Registry::Get().FindType(type->GetDecoratorValues(GARBAGE_SID("AssetType"))[0])->Construct(nullptr));
 
-					Ref<Asset> asset = Ref<Asset>((Asset*)Meta::Registry::Get().FindType((*type->GetDecoratorValues("AssetType"))[0])->Construct(nullptr));
+					const bool created = instance->CreateFromSourceAsset(asset.get(), file.get(), extension);
+					type->Destroy(instance);
 
-					if (instance->CreateFromSourceAsset(asset.get(), file.get(), extension))
+					if (created)
 					{
 						asset->m_name = name.filename();
 						asset->m_sourcePath = std::filesystem::absolute(name);
@@ -134,6 +144,18 @@ Ref<Asset> AssetManager::LoadAsset(const std::filesystem::path& name)
 	return nullptr;
 }
 
+std::vector<Ref<Asset>> AssetManager::LoadAssets(const std::vector<std::filesystem::path>& names)
+{
+	std::vector<Ref<Asset>> assets(names.size());
+
+	JobSystem::ParallelFor(names.size(), 1, [&](uint64 index)
+		{
+			assets[index] = LoadAsset(names[index]);
+		});
+
+	return assets;
+}
+
 void AssetManager::SaveAsset(Asset* asset, const std::filesystem::path& path)
 {
 	FileEntry fileEntry;
@@ -154,7 +176,7 @@ void AssetManager::SaveAsset(Asset* asset, const std::filesystem::path& path)
 	{
 		auto type = factory->GetType();
 
-		if ((*type->GetDecoratorValues("AssetType"))[0] == assetType->GetName())
+		if (type->GetDecoratorValues(GARBAGE_SID("AssetType"))[0] == assetType->GetName())
 		{
 			if (factory->Serialize(asset, file.get()))
 			{
@@ -173,21 +195,21 @@ AssetManager::AssetType AssetManager::GetAssetType(const std::filesystem::path&
 	{
 		auto type = factory->GetType();
 
-		if (type->HasDecorator("ConvertedFormat"))
+		if (type->HasDecorator(GARBAGE_SID("ConvertedFormat")))
 		{
-			auto convertedFileExtensions = type->GetDecoratorValues("ConvertedFormat");
+			auto convertedFileExtensions = type->GetDecoratorValues(GARBAGE_SID("ConvertedFormat"));
 
-			for (auto& format : *convertedFileExtensions)
+			for (auto& format : convertedFileExtensions)
 			{
 				if (format == extension) return AssetType::Cooked;
 			}
 		}
 
-		if (type->HasDecorator("SourceFileFormats"))
+		if (type->HasDecorator(GARBAGE_SID("SourceFileFormats")))
 		{
-			auto sourceFileExtensions = type->GetDecoratorValues("SourceFileFormats");
+			auto sourceFileExtensions = type->GetDecoratorValues(GARBAGE_SID("SourceFileFormats"));
 
-			for (auto& format : *sourceFileExtensions)
+			for (auto& format : sourceFileExtensions)
 			{
 				if (format == extension) return AssetType::Source;
 			}
@@ -209,15 +231,15 @@ bool AssetManager::SourceAssetHasCookedAsset(const std::filesystem::path& name)
 	{
 		auto type = factory->GetType();
 
-		if (type->HasDecorator("ConvertedFormat") && type->HasDecorator("SourceFileFormats"))
+		if (type->HasDecorator(GARBAGE_SID("ConvertedFormat")) && type->HasDecorator(GARBAGE_SID("SourceFileFormats")))
 		{
-			auto sourceFileExtensions = type->GetDecoratorValues("SourceFileFormats");
+			auto sourceFileExtensions = type->GetDecoratorValues(GARBAGE_SID("SourceFileFormats"));
 
-			for (auto& sourceFormat : *sourceFileExtensions)
+			for (auto& sourceFormat : sourceFileExtensions)
 			{
 				if (sourceFormat == extension)
 				{
-					for (auto& convertedFormat : *type->GetDecoratorValues("ConvertedFormat"))
+					for (auto& convertedFormat : type->GetDecoratorValues(GARBAGE_SID("ConvertedFormat")))
 					{
 						auto filename = stem + convertedFormat;
 
@@ -2,6 +2,14 @@
 #include <stb_image/stb_image.h>
 #include <stb_image/stb_image_write.h>
 
+void Texture2DAsset::SetData(uint8* data, uint64 size)
+{
+	m_data = Ref<uint8[]>(data);
+	m_dataSize.Set(size);
+}
+
+
+
 bool Texture2DAssetFactory::CreateFromSourceAsset(Asset* output, File* file, std::string_view sourceFileExtension)
 {
 	auto rawData = file->ReadToEnd();
@@ -17,7 +25,7 @@ bool Texture2DAssetFactory::CreateFromSourceAsset(Asset* output, File* file, std
 
 	Texture2DAsset* textureAsset = (Texture2DAsset*)output;
 
-	textureAsset->m_data = Ref<uint8[]>(data);
+	textureAsset->SetData(data, (uint64)x * (uint64)y * (uint64)numColorChannels);
 
 	textureAsset->m_size = Vector2((float)x, (float)y);
 	textureAsset->m_numberOfColorChannels = numColorChannels;
@@ -65,7 +73,7 @@ bool Texture2DAssetFactory::Deserialize(Asset* asset, File* stream)
 
 	uint8* data = stream->ReadToEnd();
 
-	textureAsset->m_data = Ref<uint8[]>(data);
+	textureAsset->SetData(data, size);
 
 	textureAsset->m_size = Vector2((float)width, (float)height);
 	textureAsset->m_numberOfColorChannels = numberOfColorChannels;
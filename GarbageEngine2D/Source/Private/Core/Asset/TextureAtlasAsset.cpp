@@ -0,0 +1,154 @@
+#include "Core/Asset/TextureAtlasAsset.h"
+#include "Core/Asset/AssetManager.h"
+#include "Core/Asset/Texture2D.h"
+#include "Rendering/TextureAtlas.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+bool TextureAtlasAssetFactory::CreateFromSourceAsset(Asset* output, File* file, std::string_view sourceFileExtension)
+{
+	std::string contents;
+	file->ReadToEnd(contents);
+
+	std::vector<std::filesystem::path> names;
+
+	std::istringstream lines(contents);
+	std::string line;
+
+	while (std::getline(lines, line))
+	{
+		line.erase(std::find_if(line.rbegin(), line.rend(), [](unsigned char c) { return !std::isspace(c); }).base(), line.end());
+		if (line.empty() || line[0] == '#') continue;
+
+		names.emplace_back(line);
+	}
+
+	auto assets = AssetManager::LoadAssets(names);
+
+	std::vector<std::pair<std::string, Ref<Texture2DAsset>>> textures;
+
+	for (uint64 i = 0; i < names.size(); i++)
+	{
+		auto texture = std::dynamic_pointer_cast<Texture2DAsset>(assets[i]);
+		if (!texture)
+		{
+			GARBAGE_CORE_WARN("Can't load texture {} for atlas", names[i].string());
+			continue;
+		}
+
+		textures.emplace_back(names[i].string(), texture);
+	}
+
+	TextureAtlasAsset* atlasAsset = (TextureAtlasAsset*)output;
+	atlasAsset->Filtering = Texture::Filtering::Linear;
+
+	const uint16 pageSize = atlasAsset->m_pageSize;
+	const uint16 padding = atlasAsset->m_padding;
+
+	// Packing the tallest textures first leaves a much flatter skyline
+	std::stable_sort(textures.begin(), textures.end(), [](const auto& a, const auto& b)
+		{
+			return a.second->GetSize().Y > b.second->GetSize().Y;
+		});
+
+	std::vector<SkylinePacker> packers;
+
+	for (auto& [name, texture] : textures)
+	{
+		const uint16 width = (uint16)texture->GetSize().X;
+		const uint16 height = (uint16)texture->GetSize().Y;
+
+		if ((uint32)width + 2 * padding > pageSize || (uint32)height + 2 * padding > pageSize)
+		{
+			GARBAGE_CORE_WARN("Texture {} ({}x{}) does not fit into atlas page of size {}", name, width, height, pageSize);
+			continue;
+		}
+
+		const uint16 paddedWidth = width + 2 * padding;
+		const uint16 paddedHeight = height + 2 * padding;
+
+		uint16 x = 0, y = 0;
+		uint64 page = 0;
+
+		for (; page < packers.size(); page++)
+		{
+			if (packers[page].Pack(paddedWidth, paddedHeight, x, y)) break;
+		}
+
+		if (page == packers.size())
+		{
+			packers.emplace_back(pageSize, pageSize).Pack(paddedWidth, paddedHeight, x, y);
+
+			const uint64 pageDataSize = (uint64)pageSize * (uint64)pageSize * 4;
+			atlasAsset->m_pages.emplace_back(new uint8[pageDataSize]());
+			atlasAsset->m_pagesSize.Set(atlasAsset->m_pages.size() * pageDataSize);
+		}
+
+		TextureAtlas::CopyToPage(atlasAsset->m_pages[page].get(), pageSize, x, y, padding,
+			texture->GetData(), width, height, texture->GetNumberOfColorChannels());
+
+		atlasAsset->m_regions.push_back({ name, (uint16)page, (uint16)(x + padding), (uint16)(y + padding), width, height });
+	}
+
+	for (uint64 i = 0; i < packers.size(); i++)
+	{
+		GARBAGE_CORE_TRACE("Atlas page {} occupancy: {:.1f}%", i, packers[i].GetOccupancy() * 100.0f);
+	}
+
+	return true;
+}
+
+bool TextureAtlasAssetFactory::Serialize(Asset* asset, File* stream)
+{
+	TextureAtlasAsset* atlasAsset = (TextureAtlasAsset*)asset;
+
+	*stream << atlasAsset->m_pageSize << atlasAsset->m_padding << (uint8)atlasAsset->Filtering;
+	*stream << (uint64)atlasAsset->m_pages.size() << (uint64)atlasAsset->m_regions.size();
+
+	for (auto& region : atlasAsset->m_regions)
+	{
+		*stream << region.Name << region.Page << region.X << region.Y << region.Width << region.Height;
+	}
+
+	const uint64 pageDataSize = (uint64)atlasAsset->m_pageSize * (uint64)atlasAsset->m_pageSize * 4;
+
+	for (auto& page : atlasAsset->m_pages)
+	{
+		stream->WriteRawString(page.get(), pageDataSize);
+	}
+
+	return true;
+}
+
+bool TextureAtlasAssetFactory::Deserialize(Asset* asset, File* stream)
+{
+	TextureAtlasAsset* atlasAsset = (TextureAtlasAsset*)asset;
+
+	uint8 filtering = 0;
+	uint64 numberOfPages = 0;
+	uint64 numberOfRegions = 0;
+
+	*stream >> atlasAsset->m_pageSize >> atlasAsset->m_padding >> filtering >> numberOfPages >> numberOfRegions;
+
+	atlasAsset->Filtering = (Texture::Filtering)filtering;
+
+	atlasAsset->m_regions.resize(numberOfRegions);
+	for (auto& region : atlasAsset->m_regions)
+	{
+		*stream >> region.Name >> region.Page >> region.X >> region.Y >> region.Width >> region.Height;
+	}
+
+	const uint64 pageDataSize = (uint64)atlasAsset->m_pageSize * (uint64)atlasAsset->m_pageSize * 4;
+
+	atlasAsset->m_pages.resize(numberOfPages);
+	for (auto& page : atlasAsset->m_pages)
+	{
+		page = Ref<uint8[]>(new uint8[pageDataSize]);
+		stream->ReadRawString(page.get(), pageDataSize);
+	}
+
+	atlasAsset->m_pagesSize.Set(numberOfPages * pageDataSize);
+
+	return true;
+}
\ No newline at end of file
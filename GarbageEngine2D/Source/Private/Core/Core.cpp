@@ -1,6 +1,8 @@
 #include "Core/Core.h"
+#include "Core/JobSystem.h"
 #include "Core/Log.h"
 #include "Core/Registry.h"
+#include "Rendering/GpuTimer.h"
 #include "GarbageEngine2DReflection.h"
 
 #ifdef GARBAGE_PLATFORM_WINDOWS
@@ -17,7 +19,16 @@ namespace GarbageEngine2D
 	void Init()
 	{
 		Log::Init();
+		JobSystem::Init();
 		GarbageEngine2DReflection::Register();
 	}
 
+	void Shutdown()
+	{
+		GpuTimer::Shutdown();
+		JobSystem::Shutdown();
+		// Last, so messages logged while shutting down are still written
+		Log::Shutdown();
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,346 @@
+#include "Core/JobSystem.h"
+#include "Core/Assert.h"
+#include "Core/Log.h"
+#include "Core/Profiling.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Must be a power of two
+static constexpr uint32 MaxJobsPerThread = 4096;
+static constexpr uint32 SpinsBeforeSleep = 64;
+
+static thread_local uint32 t_threadIndex = JobSystem::NotAWorker;
+
+// Chase-Lev deque. The owning worker pushes and pops at the bottom, other workers steal from the top
+class JobSystem::WorkStealingQueue
+{
+public:
+
+	bool Push(Job* job)
+	{
+		const int64 bottom = m_bottom.load(std::memory_order_relaxed);
+		const int64 top = m_top.load(std::memory_order_acquire);
+
+		if (bottom - top >= (int64)MaxJobsPerThread) return false;
+
+		m_jobs[bottom & (MaxJobsPerThread - 1)].store(job, std::memory_order_relaxed);
+		m_bottom.store(bottom + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	Job* Pop()
+	{
+		const int64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = m_jobs[bottom & (MaxJobsPerThread - 1)].load(std::memory_order_relaxed);
+
+		// The last job can be stolen at the same time, whoever moves the top first gets it
+		if (top == bottom)
+		{
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return job;
+	}
+
+	Job* Steal()
+	{
+		int64 top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64 bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom) return nullptr;
+
+		Job* job = m_jobs[top & (MaxJobsPerThread - 1)].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+
+		return job;
+	}
+
+private:
+
+	std::atomic<int64> m_top{ 0 };
+	std::atomic<int64> m_bottom{ 0 };
+	std::atomic<Job*> m_jobs[MaxJobsPerThread]{};
+
+};
+
+struct JobSystem::Worker
+{
+	WorkStealingQueue Queue;
+
+	// Jobs are taken from a ring, so submitting doesn't allocate
+	Scope<Job[]> Jobs{ new Job[MaxJobsPerThread] };
+	uint32 NextJob{ 0 };
+
+	uint32 RandomState;
+	std::thread Thread;
+};
+
+struct JobSystem::Data
+{
+	std::vector<Scope<Worker>> Workers;
+	bool Initialized{ false };
+
+	// Jobs submitted from threads that are not workers
+	std::mutex InjectedJobsMutex;
+	std::deque<Job*> InjectedJobs;
+	std::atomic<uint64> NumberOfInjectedJobs{ 0 };
+
+	std::atomic<uint64> PendingJobs{ 0 };
+	std::atomic<uint32> SleepingWorkers{ 0 };
+	std::atomic<bool> Quit{ false };
+	std::mutex SleepMutex;
+	std::condition_variable WakeUp;
+
+	~Data() { JobSystem::Shutdown(); }
+};
+
+JobSystem::Data JobSystem::s_data;
+
+void JobSystem::Init(uint32 numberOfThreads)
+{
+	CALL_ONLY_ONCE();
+
+	if (numberOfThreads == 0) numberOfThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	s_data.Workers.reserve(numberOfThreads);
+	for (uint32 i = 0; i < numberOfThreads; i++)
+	{
+		s_data.Workers.push_back(MakeScope<Worker>());
+		s_data.Workers.back()->RandomState = i * 2654435761u + 1;
+	}
+
+	t_threadIndex = 0;
+	Profiler::SetThreadName("Main");
+	s_data.Quit = false;
+	s_data.Initialized = true;
+
+	for (uint32 i = 1; i < numberOfThreads; i++)
+	{
+		s_data.Workers[i]->Thread = std::thread(&JobSystem::WorkerMain, i);
+	}
+
+	GARBAGE_CORE_INFO("Job system is running on {} threads", numberOfThreads);
+}
+
+void JobSystem::Shutdown()
+{
+	if (!s_data.Initialized) return;
+
+	{
+		std::scoped_lock<std::mutex> lock(s_data.SleepMutex);
+		s_data.Quit = true;
+	}
+
+	s_data.WakeUp.notify_all();
+
+	for (auto& worker : s_data.Workers)
+	{
+		if (worker->Thread.joinable()) worker->Thread.join();
+	}
+
+	s_data.Workers.clear();
+	s_data.Initialized = false;
+	t_threadIndex = NotAWorker;
+}
+
+bool JobSystem::IsInitialized()
+{
+	return s_data.Initialized;
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!TryExecuteJob()) std::this_thread::yield();
+	}
+}
+
+uint32 JobSystem::GetNumberOfThreads()
+{
+	return s_data.Initialized ? (uint32)s_data.Workers.size() : 1;
+}
+
+uint32 JobSystem::GetCurrentThreadIndex()
+{
+	return t_threadIndex;
+}
+
+JobSystem::Job* JobSystem::AllocateJob()
+{
+	const uint32 index = t_threadIndex;
+
+	if (index != NotAWorker && s_data.Initialized)
+	{
+		Worker& worker = *s_data.Workers[index];
+		Job& job = worker.Jobs[worker.NextJob++ & (MaxJobsPerThread - 1)];
+
+		// Fall back to the heap when the ring wraps around onto a job that still hasn't run
+		if (!job.InUse.load(std::memory_order_acquire))
+		{
+			job.InUse.store(true, std::memory_order_relaxed);
+			job.HeapAllocated = false;
+			return &job;
+		}
+	}
+
+	Job* job = new Job();
+	job->HeapAllocated = true;
+
+	return job;
+}
+
+void JobSystem::Submit(Job* job)
+{
+	if (!s_data.Initialized)
+	{
+		Execute(job);
+		return;
+	}
+
+	const uint32 index = t_threadIndex;
+
+	if (index == NotAWorker || !s_data.Workers[index]->Queue.Push(job))
+	{
+		std::scoped_lock<std::mutex> lock(s_data.InjectedJobsMutex);
+		s_data.InjectedJobs.push_back(job);
+		s_data.NumberOfInjectedJobs.fetch_add(1, std::memory_order_release);
+	}
+
+	s_data.PendingJobs.fetch_add(1);
+
+	if (s_data.SleepingWorkers.load() > 0)
+	{
+		std::scoped_lock<std::mutex> lock(s_data.SleepMutex);
+		s_data.WakeUp.notify_one();
+	}
+}
+
+bool JobSystem::TryExecuteJob()
+{
+	if (!s_data.Initialized) return false;
+
+	const uint32 index = t_threadIndex;
+	Job* job = nullptr;
+
+	if (index != NotAWorker) job = s_data.Workers[index]->Queue.Pop();
+
+	if (!job && s_data.NumberOfInjectedJobs.load(std::memory_order_acquire) > 0)
+	{
+		std::scoped_lock<std::mutex> lock(s_data.InjectedJobsMutex);
+
+		if (!s_data.InjectedJobs.empty())
+		{
+			job = s_data.InjectedJobs.front();
+			s_data.InjectedJobs.pop_front();
+			s_data.NumberOfInjectedJobs.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (job && DeferIfBlocked(job)) job = nullptr;
+
+	if (!job)
+	{
+		const uint32 numberOfWorkers = (uint32)s_data.Workers.size();
+
+		// Xorshift, every thread starts looking for victims at a different worker
+		uint32 start = 0;
+		if (index != NotAWorker)
+		{
+			uint32& state = s_data.Workers[index]->RandomState;
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			start = state;
+		}
+
+		for (uint32 i = 0; i < numberOfWorkers && !job; i++)
+		{
+			const uint32 victim = (start + i) % numberOfWorkers;
+			if (victim == index) continue;
+
+			job = s_data.Workers[victim]->Queue.Steal();
+			if (job && DeferIfBlocked(job)) job = nullptr;
+		}
+	}
+
+	if (!job) return false;
+
+	s_data.PendingJobs.fetch_sub(1);
+	Execute(job);
+
+	return true;
+}
+
+// Blocking the worker inside a job would nest every job it runs while waiting on its stack
+bool JobSystem::DeferIfBlocked(Job* job)
+{
+	if (!job->Dependency || job->Dependency->IsDone()) return false;
+
+	std::scoped_lock<std::mutex> lock(s_data.InjectedJobsMutex);
+	s_data.InjectedJobs.push_back(job);
+	s_data.NumberOfInjectedJobs.fetch_add(1, std::memory_order_release);
+
+	return true;
+}
+
+void JobSystem::Execute(Job* job)
+{
+	// Without workers jobs run inline in submission order, so the dependency is already done
+	GARBAGE_CORE_ASSERT(!job->Dependency || job->Dependency->IsDone());
+
+	job->Execute(job->Data);
+
+	JobCounter* counter = job->Counter;
+
+	if (job->HeapAllocated) delete job;
+	else job->InUse.store(false, std::memory_order_release);
+
+	if (counter) counter->m_value.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerMain(uint32 index)
+{
+	t_threadIndex = index;
+	Profiler::SetThreadName("Job worker");
+
+	uint32 spins = 0;
+
+	while (!s_data.Quit.load(std::memory_order_relaxed))
+	{
+		if (TryExecuteJob())
+		{
+			spins = 0;
+			continue;
+		}
+
+		if (++spins < SpinsBeforeSleep)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		spins = 0;
+
+		std::unique_lock<std::mutex> lock(s_data.SleepMutex);
+		s_data.SleepingWorkers.fetch_add(1);
+		s_data.WakeUp.wait(lock, []() { return s_data.Quit.load() || s_data.PendingJobs.load() > 0; });
+		s_data.SleepingWorkers.fetch_sub(1);
+	}
+}
\ No newline at end of file
@@ -2,7 +2,245 @@
 #pragma warning(push, 0)
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/details/log_msg_buffer.h>
 #pragma warning(pop)
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Copies messages into a bounded lock-free queue (Vyukov's MPMC ring) and writes them to the wrapped sink
+// on a background thread. Every cell's sequence number tells whose turn it is, a producer of that position or a consumer
+class AsyncLogSink final : public spdlog::sinks::sink
+{
+public:
+
+	AsyncLogSink(spdlog::sink_ptr sink, const Log::Specification& specification)
+		: m_sink(std::move(sink)), m_overflow(specification.Overflow), m_flushInterval(specification.FlushIntervalMilliseconds)
+	{
+		uint64 size = 2;
+		while (size < specification.QueueSize) size *= 2;
+
+		m_cells.reset(new Cell[size]);
+		m_mask = size - 1;
+
+		for (uint64 i = 0; i < size; i++) m_cells[i].Sequence.store(i, std::memory_order_relaxed);
+
+		m_thread = std::thread(&AsyncLogSink::WorkerMain, this);
+	}
+
+	~AsyncLogSink() override
+	{
+		Stop();
+	}
+
+	void log(const spdlog::details::log_msg& message) override
+	{
+		// Stop drains until no producer is inside, so a message that passed the check below is never lost.
+		// Both sides are sequentially consistent, either Stop sees the producer or the producer sees m_stopped
+		m_producers.fetch_add(1);
+
+		// Messages logged after the thread stopped, e.g. from static destructors, are written directly
+		if (m_stopped.load())
+		{
+			m_producers.fetch_sub(1);
+			m_sink->log(message);
+			return;
+		}
+
+		while (!TryPush(message))
+		{
+			switch (m_overflow)
+			{
+				case Log::OverflowPolicy::Block:
+					m_wakeUp.notify_one();
+					std::this_thread::yield();
+					break;
+				case Log::OverflowPolicy::Drop:
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+					m_producers.fetch_sub(1);
+					return;
+				case Log::OverflowPolicy::Overwrite:
+					if (spdlog::details::log_msg_buffer oldest; TryPop(oldest))
+					{
+						m_dropped.fetch_add(1, std::memory_order_relaxed);
+						m_completed.fetch_add(1, std::memory_order_release);
+					}
+					break;
+			}
+		}
+
+		m_producers.fetch_sub(1);
+		m_wakeUp.notify_one();
+	}
+
+	// Waits until everything logged so far is written
+	void flush() override
+	{
+		const uint64 target = m_enqueued.load(std::memory_order_acquire);
+
+		while (!m_stopped.load(std::memory_order_acquire) && m_completed.load(std::memory_order_acquire) < target)
+		{
+			m_wakeUp.notify_one();
+			std::this_thread::yield();
+		}
+
+		m_sink->flush();
+	}
+
+	void set_pattern(const std::string& pattern) override { m_sink->set_pattern(pattern); }
+	void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override { m_sink->set_formatter(std::move(formatter)); }
+
+	void Stop()
+	{
+		if (!m_thread.joinable()) return;
+
+		m_quit.store(true, std::memory_order_release);
+		m_wakeUp.notify_one();
+		m_thread.join();
+
+		m_stopped.store(true);
+
+		// Producers that passed the check before the store may still be pushing, or blocked on a full queue
+		spdlog::details::log_msg_buffer message;
+		while (true)
+		{
+			const bool producing = m_producers.load() != 0;
+
+			while (TryPop(message))
+			{
+				m_sink->log(message);
+				m_completed.fetch_add(1, std::memory_order_release);
+			}
+
+			if (!producing) break;
+			std::this_thread::yield();
+		}
+
+		m_sink->flush();
+	}
+
+	uint64 GetNumberOfDroppedMessages() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+
+	struct Cell
+	{
+		std::atomic<uint64> Sequence{ 0 };
+		spdlog::details::log_msg_buffer Message;
+	};
+
+	spdlog::sink_ptr m_sink;
+	Log::OverflowPolicy m_overflow;
+	std::chrono::milliseconds m_flushInterval;
+
+	Scope<Cell[]> m_cells;
+	uint64 m_mask{ 0 };
+
+	alignas(64) std::atomic<uint64> m_enqueuePosition{ 0 };
+	alignas(64) std::atomic<uint64> m_dequeuePosition{ 0 };
+
+	// Used by flush to know when everything logged before it is written
+	std::atomic<uint64> m_enqueued{ 0 };
+	std::atomic<uint64> m_completed{ 0 };
+	std::atomic<uint64> m_dropped{ 0 };
+
+	std::atomic<bool> m_quit{ false };
+	std::atomic<bool> m_stopped{ false };
+	// Threads inside of log that may still push
+	std::atomic<uint32> m_producers{ 0 };
+	std::mutex m_wakeUpMutex;
+	std::condition_variable m_wakeUp;
+	std::thread m_thread;
+
+	bool TryPush(const spdlog::details::log_msg& message)
+	{
+		uint64 position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			Cell& cell = m_cells[position & m_mask];
+			const int64 difference = (int64)cell.Sequence.load(std::memory_order_acquire) - (int64)position;
+
+			if (difference < 0) return false;
+
+			if (difference == 0 && m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				cell.Message = spdlog::details::log_msg_buffer(message);
+				cell.Sequence.store(position + 1, std::memory_order_release);
+				m_enqueued.fetch_add(1, std::memory_order_release);
+
+				return true;
+			}
+
+			if (difference > 0) position = m_enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	bool TryPop(spdlog::details::log_msg_buffer& message)
+	{
+		uint64 position = m_dequeuePosition.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			Cell& cell = m_cells[position & m_mask];
+			const int64 difference = (int64)cell.Sequence.load(std::memory_order_acquire) - (int64)(position + 1);
+
+			if (difference < 0) return false;
+
+			if (difference == 0 && m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				message = std::move(cell.Message);
+				cell.Sequence.store(position + m_mask + 1, std::memory_order_release);
+
+				return true;
+			}
+
+			if (difference > 0) position = m_dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	bool IsEmpty() const
+	{
+		return m_dequeuePosition.load(std::memory_order_relaxed) == m_enqueuePosition.load(std::memory_order_relaxed);
+	}
+
+	void WorkerMain()
+	{
+		spdlog::details::log_msg_buffer message;
+
+		auto lastFlush = std::chrono::steady_clock::now();
+		bool written = false;
+
+		while (true)
+		{
+			while (TryPop(message))
+			{
+				m_sink->log(message);
+				m_completed.fetch_add(1, std::memory_order_release);
+				written = true;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			if (written && now - lastFlush >= m_flushInterval)
+			{
+				m_sink->flush();
+				lastFlush = now;
+				written = false;
+			}
+
+			if (m_quit.load(std::memory_order_acquire)) break;
+
+			// Producers don't lock when notifying, the timeout covers a missed notification
+			std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+			m_wakeUp.wait_for(lock, std::chrono::milliseconds(10), [this]() { return m_quit.load(std::memory_order_acquire) || !IsEmpty(); });
+		}
+	}
+
+};
+
+static Ref<AsyncLogSink> s_asyncSink;
 
 GARBAGE_API Ref<spdlog::logger> Log::s_coreLogger;
 GARBAGE_API Ref<spdlog::logger> Log::s_clientLogger;
@@ -14,17 +252,43 @@ template GARBAGE_API std::ostream& operator<< <std::ostream>(std::ostream& os, c
 template GARBAGE_API std::ostream& operator<< <std::ostream>(std::ostream& os, const Quaternion& quat);
 template GARBAGE_API std::ostream& operator<< <std::ostream>(std::ostream& os, const Color& color);
 
-void Log::Init()
+void Log::Init(const Specification& specification)
 {
-	s_coreLogger = spdlog::stdout_color_mt("Garbage Core");
+	if (specification.Asynchronous)
+	{
+		// Both loggers share one queue and one thread, so their messages stay in order
+		s_asyncSink = MakeRef<AsyncLogSink>(std::make_shared<spdlog::sinks::stdout_color_sink_mt>(), specification);
+
+		s_coreLogger = MakeRef<spdlog::logger>("Garbage Core", s_asyncSink);
+		s_clientLogger = MakeRef<spdlog::logger>("Application", s_asyncSink);
+
+		// Errors usually come right before an assert breaks into the debugger
+		s_coreLogger->flush_on(spdlog::level::err);
+		s_clientLogger->flush_on(spdlog::level::err);
+	}
+	else
+	{
+		s_coreLogger = spdlog::stdout_color_mt("Garbage Core");
+		s_clientLogger = spdlog::stdout_color_mt("Application");
+	}
+
 	s_coreLogger->set_level(spdlog::level::trace);
 	s_coreLogger->set_pattern("%^[%T] %n: %v%$");
 
-	s_clientLogger = spdlog::stdout_color_mt("Application");
 	s_clientLogger->set_level(spdlog::level::trace);
 	s_clientLogger->set_pattern("%^[%T] %n: %v%$");
 }
 
+void Log::Shutdown()
+{
+	if (s_asyncSink) s_asyncSink->Stop();
+}
+
+uint64 Log::GetNumberOfDroppedMessages()
+{
+	return s_asyncSink ? s_asyncSink->GetNumberOfDroppedMessages() : 0;
+}
+
 Ref<spdlog::logger> Log::GetClientLogger()
 {
 	return s_clientLogger;
@@ -0,0 +1,166 @@
+#include "Core/Profiling.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct ProfilerThreadBuffer
+{
+	Scope<Profiler::Event[]> Events{ new Profiler::Event[Profiler::EventsPerThread] };
+
+	// Written only by the owning thread
+	std::atomic<uint64> WriteIndex{ 0 };
+	// Events before this index were cleared
+	std::atomic<uint64> ReadIndex{ 0 };
+
+	uint32 ThreadIndex{ 0 };
+	std::string Name;
+};
+
+std::atomic<bool> Profiler::s_enabled{ false };
+
+static const std::chrono::steady_clock::time_point s_startTime = std::chrono::steady_clock::now();
+static std::atomic<int64> s_frameIndex{ 0 };
+
+// Buffers are never freed, so events of finished threads can still be exported
+static std::mutex s_buffersMutex;
+static std::vector<Scope<ProfilerThreadBuffer>> s_buffers;
+
+static thread_local ProfilerThreadBuffer* t_buffer = nullptr;
+
+static ProfilerThreadBuffer& GetThreadBuffer()
+{
+	if (t_buffer) return *t_buffer;
+
+	std::scoped_lock<std::mutex> lock(s_buffersMutex);
+
+	s_buffers.push_back(MakeScope<ProfilerThreadBuffer>());
+	s_buffers.back()->ThreadIndex = (uint32)s_buffers.size() - 1;
+
+	t_buffer = s_buffers.back().get();
+	return *t_buffer;
+}
+
+static void WriteEscaped(std::ostream& stream, std::string_view text)
+{
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\') stream << '\\';
+		stream << c;
+	}
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	ProfilerThreadBuffer& buffer = GetThreadBuffer();
+
+	std::scoped_lock<std::mutex> lock(s_buffersMutex);
+	buffer.Name = name;
+}
+
+void Profiler::MarkFrame()
+{
+	const int64 frameIndex = s_frameIndex.fetch_add(1, std::memory_order_relaxed);
+
+	if (IsEnabled()) Record(EventType::Frame, "Frame", frameIndex);
+}
+
+bool Profiler::ExportChromeTrace(const std::filesystem::path& path)
+{
+	std::ofstream stream(path, std::ios::out | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		GARBAGE_CORE_WARN("Can't open {} for profiler capture", path.string());
+		return false;
+	}
+
+	stream << std::fixed << std::setprecision(3);
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	auto beginEvent = [&](const char* name, const char* phase, uint32 threadIndex)
+	{
+		stream << (first ? "\n" : ",\n") << "{\"name\":\"";
+		WriteEscaped(stream, name);
+		stream << "\",\"ph\":\"" << phase << "\",\"pid\":0,\"tid\":" << threadIndex;
+
+		first = false;
+	};
+
+	std::scoped_lock<std::mutex> lock(s_buffersMutex);
+
+	for (auto& buffer : s_buffers)
+	{
+		if (!buffer->Name.empty())
+		{
+			beginEvent("thread_name", "M", buffer->ThreadIndex);
+			stream << ",\"args\":{\"name\":\"";
+			WriteEscaped(stream, buffer->Name);
+			stream << "\"}}";
+		}
+
+		const uint64 end = buffer->WriteIndex.load(std::memory_order_acquire);
+		const uint64 begin = std::max(buffer->ReadIndex.load(std::memory_order_relaxed), end > EventsPerThread ? end - EventsPerThread : 0);
+
+		// Scopes whose begin was overwritten or cleared are dropped
+		uint64 depth = 0;
+
+		for (uint64 i = begin; i < end; i++)
+		{
+			const Event& event = buffer->Events[i & (EventsPerThread - 1)];
+			const double timestamp = (double)event.Timestamp / 1000.0;
+
+			switch (event.Type)
+			{
+				case EventType::Begin:
+					depth++;
+					beginEvent(event.Name, "B", buffer->ThreadIndex);
+					stream << ",\"ts\":" << timestamp << "}";
+					break;
+				case EventType::End:
+					if (depth == 0) break;
+					depth--;
+					beginEvent(event.Name, "E", buffer->ThreadIndex);
+					stream << ",\"ts\":" << timestamp << "}";
+					break;
+				case EventType::Counter:
+					beginEvent(event.Name, "C", buffer->ThreadIndex);
+					stream << ",\"ts\":" << timestamp << ",\"args\":{\"value\":" << event.Value << "}}";
+					break;
+				case EventType::Frame:
+					beginEvent(event.Name, "i", buffer->ThreadIndex);
+					stream << ",\"ts\":" << timestamp << ",\"s\":\"g\",\"args\":{\"index\":" << event.Value << "}}";
+					break;
+			}
+		}
+	}
+
+	stream << "\n]}";
+
+	GARBAGE_CORE_INFO("Profiler capture saved to {}", path.string());
+
+	return stream.good();
+}
+
+void Profiler::Clear()
+{
+	std::scoped_lock<std::mutex> lock(s_buffersMutex);
+
+	for (auto& buffer : s_buffers)
+	{
+		buffer->ReadIndex.store(buffer->WriteIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
+
+void Profiler::Record(EventType type, const char* name, int64 value)
+{
+	ProfilerThreadBuffer& buffer = GetThreadBuffer();
+
+	const uint64 index = buffer.WriteIndex.load(std::memory_order_relaxed);
+	const uint64 timestamp = (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_startTime).count();
+
+	buffer.Events[index & (EventsPerThread - 1)] = { name, timestamp, value, type };
+	buffer.WriteIndex.store(index + 1, std::memory_order_release);
+}
\ No newline at end of file
@@ -1,90 +1,95 @@
 #include "Core/Registry.h"
+#include <algorithm>
+#include <cstring>
 
 Meta::Type* ObjectBase::Z_m_type = nullptr;
 
 namespace Meta
 {
 
-	static bool HasDecorator(const std::vector<Decorator>& decorators, std::string_view name, Decorator** outDecorator = nullptr)
+	// The interned copy lives as long as the process, like the strings of reflection tables
+	static const char* InternString(std::string_view string)
 	{
+		return StringId::Intern(string).GetString().c_str();
+	}
+
+	ArrayView<DecoratorDescriptor> DecoratorStorage::Store(std::initializer_list<Decorator> decorators)
+	{
+		uint64 numberOfValues = 0;
+		for (auto& decorator : decorators) numberOfValues += decorator.Values.size();
+
+		// Reserved up front, descriptors point into the values
+		Values.clear();
+		Values.reserve(numberOfValues);
+		Decorators.clear();
+		Decorators.reserve(decorators.size());
+
 		for (auto& decorator : decorators)
 		{
-			if (decorator.Name == name)
-			{
-				if (outDecorator) *outDecorator = (Meta::Decorator*)&decorator;
-				return true;
-			}
+			const char* const* values = Values.data() + Values.size();
+			for (auto& value : decorator.Values) Values.push_back(InternString(value));
+
+			StringId id = decorator.Id.IsValid() ? decorator.Id : StringId::Intern(decorator.Name);
+			Decorators.push_back({ id.GetString().c_str(), values, (uint32)decorator.Values.size(), id });
 		}
 
-		return false;
+		return Decorators;
 	}
 
 	Enum& Enum::AddValue(const std::string& name, int64 value /*= -9223372036854775807 */)
 	{
-		if (value == UnknownValue && !m_values.empty())
-		{
-			int64 lastValue = (--m_values.end())->first;
-			m_values[lastValue + 1] = name;
-		}
-		else m_values[value] = name;
+		// Like in C++, a value without an explicit number follows the previous one
+		if (value == UnknownValue) value = m_lastValue + 1;
+
+		m_values[value] = name;
+		m_indices[StringId::Intern(name)] = value;
+		m_lastValue = value;
 
 		return *this;
 	}
 
-	const std::string Enum::ValueToString(int64 value) const
+	const std::string& Enum::ValueToString(int64 value) const
 	{
+		static const std::string unknown = "Unknown";
+
 		auto it = m_values.find(value);
 		if (it != m_values.end()) return it->second;
 
-		return "Unknown";
+		return unknown;
 	}
 
-	std::optional<int64> Enum::StringToValue(const std::string& name) const
+	std::optional<int64> Enum::StringToValue(StringId id) const
 	{
-		for (auto it = m_values.begin(); it != m_values.end(); ++it)
-		{
-			if (it->second == name) return it->first;
-		}
+		auto it = m_indices.find(id);
+		if (it != m_indices.end()) return it->second;
 
 		return {};
 	}
 
-	bool Enum::HasValue(const std::string& name) const
-	{
-		for (auto it = m_values.begin(); it != m_values.end(); ++it)
-		{
-			if (it->second == name) return true;
-		}
-
-		return false;
-	}
-
-
 
-	bool Property::HasDecorator(std::string_view name) const { return Meta::HasDecorator(Decorators, name, nullptr); }
 
-	const std::vector<std::string>* Property::GetDecoratorValues(std::string_view name) const
+	DecoratorValues Property::GetDecoratorValues(StringId id) const
 	{
-		Decorator* decorator = nullptr;
-		if (!Meta::HasDecorator(Decorators, name, &decorator)) return nullptr;
+		auto decorator = FindDecorator(Decorators, id);
 
-		return &decorator->Values;
+		return decorator ? DecoratorValues(decorator->Values, decorator->NumberOfValues) : DecoratorValues();
 	}
 
 
 
 	Type::~Type()
 	{
-		for (uint64 i = 0; i < m_properties.size(); i++)
-		{
-			delete m_properties[i];
-		}
+		MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Reflection, m_ownedProperties.size() * sizeof(Property));
+		MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Reflection, sizeof(Type));
 	}
 
 	Type& Type::AddParent(const Type* parent)
 	{
 		if (parent)
 		{
+			// A frozen type changes its ancestors, so the precomputed hierarchy is no longer valid for any type
+			if (m_preorder != 0) Registry::Get().Unfreeze();
+
 			m_parents.push_back(parent);
 			((Type*)parent)->AddChild(this);
 		}
@@ -99,7 +104,7 @@ namespace Meta
 		return *this;
 	}
 
-	bool Type::HasParent(const std::string& parent) const
+	bool Type::HasParent(std::string_view parent) const
 	{
 		for (int32 i = 0; i < m_parents.size(); i++)
 		{
@@ -121,7 +126,7 @@ namespace Meta
 		return false;
 	}
 
-	bool Type::HasChild(const std::string& child) const
+	bool Type::HasChild(std::string_view child) const
 	{
 		for (int32 i = 0; i < m_children.size(); i++)
 		{
@@ -143,32 +148,78 @@ namespace Meta
 		return false;
 	}
 
-	Property* Type::FindProperty(const std::string& name) const
+	Type& Type::AddProperty(std::string_view name, std::string_view type, const PropertyLayout& layout, std::initializer_list<Decorator> decorators /*= {}*/)
+	{
+		auto& owned = m_ownedProperties.emplace_back(MakeScope<OwnedProperty>());
+		Property& property = owned->Value;
+
+		property.Id = StringId::Intern(name);
+		property.Name = property.Id.GetString();
+		property.Type = InternString(type);
+		property.Layout = layout;
+		property.Decorators = owned->Decorators.Store(decorators);
+
+		MemoryStatistics::Allocated(MemoryDomain::CPU, MemoryCategory::Reflection, sizeof(Property));
+
+		// Descendants have the property in their flattened tables too
+		if (m_preorder != 0) Registry::Get().Unfreeze();
+
+		m_properties.push_back(&property);
+
+		return *this;
+	}
+
+	void Type::SetDecorators(std::initializer_list<Decorator> decorators)
+	{
+		if (!m_ownedDecorators) m_ownedDecorators = MakeScope<DecoratorStorage>();
+
+		m_decorators = m_ownedDecorators->Store(decorators);
+	}
+
+	Property* Type::FindProperty(StringId id) const
 	{
+		if (m_preorder != 0)
+		{
+			auto it = m_propertyTable.find(id);
+
+			return it != m_propertyTable.end() ? it->second : nullptr;
+		}
+
 		for (uint64 i = 0; i < m_properties.size(); i++)
 		{
 			auto prop = m_properties[i];
 
-			if (prop->Name == name) return prop;
+			if (prop->Id == id) return prop;
 		}
 
 		for (uint64 i = 0; i < m_parents.size(); i++)
 		{
-			auto prop = m_parents[i]->FindProperty(name);
+			auto prop = m_parents[i]->FindProperty(id);
 			if (prop) return prop;
 		}
 
 		return nullptr;
 	}
 
-	bool Type::HasDecorator(std::string_view name) const { return Meta::HasDecorator(m_decorators, name, nullptr); }
+	DecoratorValues Type::GetDecoratorValues(StringId id) const
+	{
+		auto decorator = FindDecorator(m_decorators, id);
 
-	const std::vector<std::string>* Type::GetDecoratorValues(std::string_view name) const
+		return decorator ? DecoratorValues(decorator->Values, decorator->NumberOfValues) : DecoratorValues();
+	}
+
+	void Type::Destroy(ObjectBase* object) const
 	{
-		Decorator* decorator = nullptr;
-		if (!Meta::HasDecorator(m_decorators, name, &decorator)) return nullptr;
+		if (!object) return;
+
+		if (!m_allocator)
+		{
+			delete object;
+			return;
+		}
 
-		return &decorator->Values;
+		object->~ObjectBase();
+		GARBAGE_TAGGED_DEALLOCATE(m_allocator, object, m_size, m_alignment);
 	}
 
 	void Type::Serialize(Archive& archive, ObjectBase* object) const
@@ -177,6 +228,84 @@ namespace Meta
 		if (m_serializer) m_serializer(archive, object);
 	}
 
+	uint64 Type::GetTrivialSize() const
+	{
+		std::vector<PropertySpan> collected;
+		uint64 size = 0;
+
+		for (auto& span : GetSpans(collected)) size += span.Size;
+
+		return size;
+	}
+
+	void Type::CopyTrivialProperties(ObjectBase* destination, const ObjectBase* source) const
+	{
+		std::vector<PropertySpan> collected;
+
+		for (auto& span : GetSpans(collected))
+		{
+			std::memcpy((uint8*)destination + span.Offset, (const uint8*)source + span.Offset, span.Size);
+		}
+	}
+
+	void Type::ReadTrivialProperties(const ObjectBase* object, void* buffer) const
+	{
+		std::vector<PropertySpan> collected;
+		uint8* out = (uint8*)buffer;
+
+		for (auto& span : GetSpans(collected))
+		{
+			std::memcpy(out, (const uint8*)object + span.Offset, span.Size);
+			out += span.Size;
+		}
+	}
+
+	void Type::WriteTrivialProperties(ObjectBase* object, const void* buffer) const
+	{
+		std::vector<PropertySpan> collected;
+		const uint8* in = (const uint8*)buffer;
+
+		for (auto& span : GetSpans(collected))
+		{
+			std::memcpy((uint8*)object + span.Offset, in, span.Size);
+			in += span.Size;
+		}
+	}
+
+	const std::vector<PropertySpan>& Type::GetSpans(std::vector<PropertySpan>& collected) const
+	{
+		if (m_preorder != 0) return m_trivialSpans;
+
+		CollectTrivialSpans(collected);
+
+		return collected;
+	}
+
+	void Type::CollectTrivialSpans(std::vector<PropertySpan>& spans) const
+	{
+		spans.clear();
+
+		// Only along the first parents, other parents don't start where the object does
+		for (const Type* type = this; type; type = type->m_parents.empty() ? nullptr : type->m_parents[0])
+		{
+			for (auto property : type->m_properties)
+			{
+				if (IsTrivialKind(property->Layout.Kind)) spans.push_back({ property->Layout.Offset, property->Layout.Size });
+			}
+		}
+
+		std::sort(spans.begin(), spans.end(), [](const PropertySpan& a, const PropertySpan& b) { return a.Offset < b.Offset; });
+
+		uint64 count = 0;
+		for (auto& span : spans)
+		{
+			if (count > 0 && spans[count - 1].Offset + spans[count - 1].Size == span.Offset) spans[count - 1].Size += span.Size;
+			else spans[count++] = span;
+		}
+
+		spans.resize(count);
+	}
+
 
 	
 	Registry& Registry::Get()
@@ -186,11 +315,30 @@ namespace Meta
 		return instance;
 	}
 
-	const Type* Registry::FindType(const std::string& name) const
+	Registry::~Registry()
+	{
+		for (auto& properties : m_tableProperties)
+		{
+			MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Reflection, properties.size() * sizeof(Property));
+		}
+	}
+
+	const Type* Registry::FindType(std::string_view name) const
 	{
 		auto type = m_types.find(name);
 
-		return type != m_types.end() ? type->second.get() : nullptr;
+		return type != m_types.end() ? type->second : nullptr;
+	}
+
+	Type& Registry::CreateType(std::string_view name)
+	{
+		Type& type = m_typeBlocks.emplace_back(MakeScope<Type[]>(1))[0];
+		type.m_name = InternString(name);
+		type.m_id = m_lastClassId++;
+
+		m_types[type.m_name] = &type;
+
+		return type;
 	}
 
 	Enum& Registry::AddEnum(const std::string& name)
@@ -201,12 +349,81 @@ namespace Meta
 
 	const Enum* Registry::FindEnum(const std::string& name) const
 	{
-		for (auto& pair : m_enums)
+		auto enumerator = m_enums.find(name);
+
+		return enumerator != m_enums.end() ? enumerator->second.get() : nullptr;
+	}
+
+	void Registry::AddTypes(const TypeDescriptor* types)
+	{
+		uint64 numberOfTypes = 0;
+		uint64 numberOfProperties = 0;
+
+		for (auto type = types; type->Name; type++)
 		{
-			if (pair.first == name) return pair.second.get();
+			numberOfTypes++;
+			numberOfProperties += type->NumberOfProperties;
 		}
 
-		return nullptr;
+		m_types.reserve(m_types.size() + numberOfTypes);
+
+		// Types and properties only point at the table, nothing is copied
+		Type* block = m_typeBlocks.emplace_back(MakeScope<Type[]>(numberOfTypes)).get();
+		auto& properties = m_tableProperties.emplace_back(numberOfProperties);
+		MemoryStatistics::Allocated(MemoryDomain::CPU, MemoryCategory::Reflection, numberOfProperties * sizeof(Property));
+
+		// All types first, so parents can be resolved regardless of the order in the table
+		Type* type = block;
+		for (auto descriptor = types; descriptor->Name; descriptor++, type++)
+		{
+			type->m_name = descriptor->Name;
+			type->m_factory = descriptor->Factory;
+			type->m_id = m_lastClassId++;
+			type->m_size = descriptor->Size;
+			type->m_alignment = descriptor->Alignment;
+			type->m_decorators = { descriptor->Decorators, descriptor->NumberOfDecorators };
+			type->m_serializer = descriptor->Serializer;
+
+			m_types[type->m_name] = type;
+		}
+
+		uint64 propertyIndex = 0;
+		type = block;
+		for (auto descriptor = types; descriptor->Name; descriptor++, type++)
+		{
+
+			// Like the step by step registration, parents that aren't reflected are skipped
+			for (uint32 i = 0; i < descriptor->NumberOfParents; i++) type->AddParent(FindType(descriptor->Parents[i]));
+
+			type->m_properties.reserve(descriptor->NumberOfProperties);
+
+			for (uint32 i = 0; i < descriptor->NumberOfProperties; i++)
+			{
+				auto& propertyDescriptor = descriptor->Properties[i];
+				Property& property = properties[propertyIndex++];
+
+				property.Name = propertyDescriptor.Name;
+				property.Type = propertyDescriptor.Type;
+				property.Layout = propertyDescriptor.GetLayout();
+				property.Decorators = { propertyDescriptor.Decorators, propertyDescriptor.NumberOfDecorators };
+				property.Id = propertyDescriptor.Id;
+
+				type->m_properties.push_back(&property);
+			}
+		}
+	}
+
+	void Registry::AddEnums(const EnumDescriptor* enums)
+	{
+		for (auto descriptor = enums; descriptor->Name; descriptor++)
+		{
+			Enum& enumerator = AddEnum(descriptor->Name);
+
+			for (uint32 i = 0; i < descriptor->NumberOfValues; i++)
+			{
+				enumerator.AddValue(descriptor->Values[i].Name, descriptor->Values[i].Value);
+			}
+		}
 	}
 
 	std::vector<const Type*> Registry::GetAllTypes() const
@@ -215,10 +432,105 @@ namespace Meta
 
 		for (auto& pair : m_types)
 		{
-			types.push_back(pair.second.get());
+			types.push_back(pair.second);
 		}
 
 		return types;
 	}
 
+	void Registry::Freeze()
+	{
+		uint32 counter = 0;
+
+		for (auto& pair : m_types)
+		{
+			if (pair.second->m_parents.empty()) counter = AssignPreorder(pair.second, counter);
+		}
+
+		for (auto& pair : m_types) pair.second->m_propertyTable.clear();
+		for (auto& pair : m_types) FlattenProperties(pair.second);
+		for (auto& pair : m_types) pair.second->CollectTrivialSpans(pair.second->m_trivialSpans);
+
+		std::vector<const Type*> stack;
+
+		for (auto& pair : m_types)
+		{
+			Type* type = pair.second;
+			type->m_ancestors.clear();
+
+			// The preorder interval covers all ancestors unless some type up the first parent chain has several parents
+			bool singleInheritance = true;
+			for (const Type* current = type; current && singleInheritance; current = current->m_parents.empty() ? nullptr : current->m_parents[0])
+			{
+				singleInheritance = current->m_parents.size() <= 1;
+			}
+
+			if (singleInheritance) continue;
+
+			type->m_ancestors.resize(m_lastClassId / 64 + 1, 0);
+			stack.assign(type->m_parents.begin(), type->m_parents.end());
+
+			while (!stack.empty())
+			{
+				const Type* ancestor = stack.back();
+				stack.pop_back();
+
+				type->m_ancestors[ancestor->m_id / 64] |= uint64(1) << (ancestor->m_id % 64);
+				stack.insert(stack.end(), ancestor->m_parents.begin(), ancestor->m_parents.end());
+			}
+		}
+
+		GARBAGE_CORE_TRACE("Froze type hierarchy of {} types", m_types.size());
+	}
+
+	uint32 Registry::AssignPreorder(Type* type, uint32 counter)
+	{
+		type->m_preorder = ++counter;
+
+		// Every type is visited from its first parent only, so the hierarchy becomes a tree
+		for (auto child : type->m_children)
+		{
+			if (child->m_parents[0] == type) counter = AssignPreorder((Type*)child, counter);
+		}
+
+		type->m_lastDescendant = counter;
+
+		return counter;
+	}
+
+	void Registry::FlattenProperties(Type* type)
+	{
+		if (!type->m_propertyTable.empty()) return;
+
+		// Same precedence as walking the hierarchy: own properties first, then each parent in order
+		for (auto property : type->m_properties) type->m_propertyTable.try_emplace(property->Id, property);
+
+		for (auto parent : type->m_parents)
+		{
+			FlattenProperties((Type*)parent);
+			for (auto& pair : parent->m_propertyTable) type->m_propertyTable.try_emplace(pair.first, pair.second);
+		}
+	}
+
+	void Registry::Unfreeze()
+	{
+		for (auto& pair : m_types)
+		{
+			pair.second->m_preorder = 0;
+			pair.second->m_ancestors.clear();
+			pair.second->m_propertyTable.clear();
+			pair.second->m_trivialSpans.clear();
+		}
+	}
+
+	PoolAllocator& Registry::BindPool(const Type* type, const PoolAllocator::Specification& specification)
+	{
+		auto& pool = m_pools[type];
+		if (!pool) pool = MakeScope<PoolAllocator>(specification);
+
+		m_types.at(type->GetName())->m_allocator = pool.get();
+
+		return *pool;
+	}
+
 }
\ No newline at end of file
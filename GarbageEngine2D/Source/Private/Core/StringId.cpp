@@ -0,0 +1,43 @@
+#include "Core/StringId.h"
+#include "Core/Assert.h"
+#include <unordered_map>
+#include <mutex>
+
+struct StringTable
+{
+	std::mutex Mutex;
+	std::unordered_map<StringId, std::string> Strings;
+};
+
+// Function local so ids can be interned during static initialization of other modules
+static StringTable& GetStringTable()
+{
+	static StringTable table;
+
+	return table;
+}
+
+StringId StringId::Intern(std::string_view string)
+{
+	StringId id(string);
+	StringTable& table = GetStringTable();
+
+	std::scoped_lock<std::mutex> lock(table.Mutex);
+
+	auto [it, inserted] = table.Strings.try_emplace(id, string);
+	GARBAGE_CORE_ASSERT(inserted || it->second == string, "String id collision with \"{}\"", it->second);
+
+	return id;
+}
+
+const std::string& StringId::GetString() const
+{
+	static const std::string empty;
+	StringTable& table = GetStringTable();
+
+	std::scoped_lock<std::mutex> lock(table.Mutex);
+
+	auto it = table.Strings.find(*this);
+
+	return it != table.Strings.end() ? it->second : empty;
+}
\ No newline at end of file
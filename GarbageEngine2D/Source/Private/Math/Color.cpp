@@ -37,6 +37,16 @@ Vector4 Color::GetAsVector4() const
 	return Vector4(R, G, B, A);
 }
 
+uint32 Color::GetAsPackedRGBA8() const
+{
+	const uint32 r = (uint32)(Math::Clamp01(R) * 255.0f + 0.5f);
+	const uint32 g = (uint32)(Math::Clamp01(G) * 255.0f + 0.5f);
+	const uint32 b = (uint32)(Math::Clamp01(B) * 255.0f + 0.5f);
+	const uint32 a = (uint32)(Math::Clamp01(A) * 255.0f + 0.5f);
+
+	return r | (g << 8) | (b << 16) | (a << 24);
+}
+
 Color Color::Lerp(const Color& other, float time) const
 {
 	return Color(Math::Lerp(R, other.R, time), Math::Lerp(G, other.G, time), Math::Lerp(B, other.B, time), Math::Lerp(A, other.A, time));
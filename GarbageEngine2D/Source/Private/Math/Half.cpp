@@ -0,0 +1,78 @@
+#include "Math/Half.h"
+#include <cstring>
+
+Half::Half(float value)
+{
+	uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	const uint16 sign = (uint16)((bits >> 16) & 0x8000);
+	const int32 exponent = (int32)((bits >> 23) & 0xff) - 127 + 15;
+	uint32 mantissa = bits & 0x7fffff;
+
+	if (exponent <= 0)
+	{
+		// Too small even for a subnormal half
+		if (exponent < -10)
+		{
+			Bits = sign;
+			return;
+		}
+
+		mantissa |= 0x800000;
+		const uint32 shift = (uint32)(14 - exponent);
+		Bits = sign | (uint16)((mantissa + (1u << (shift - 1))) >> shift);
+		return;
+	}
+
+	if (exponent >= 31)
+	{
+		// NaN is not preserved, everything out of range becomes infinity
+		Bits = sign | 0x7c00;
+		return;
+	}
+
+	// Rounding carry may move the value to the next exponent, which is still the correct result
+	Bits = sign | (uint16)((((uint32)exponent << 10) | (mantissa >> 13)) + ((mantissa >> 12) & 1));
+}
+
+Half::operator float() const
+{
+	const uint32 sign = (uint32)(Bits & 0x8000) << 16;
+	const uint32 exponent = (Bits >> 10) & 0x1f;
+	uint32 mantissa = Bits & 0x3ff;
+
+	uint32 bits = 0;
+
+	if (exponent == 0)
+	{
+		if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			int32 normalizedExponent = 1;
+			while (!(mantissa & 0x400))
+			{
+				mantissa <<= 1;
+				normalizedExponent--;
+			}
+
+			bits = sign | ((uint32)(normalizedExponent - 15 + 127) << 23) | ((mantissa & 0x3ff) << 13);
+		}
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
\ No newline at end of file
@@ -52,7 +52,7 @@ float Math::MultiplyAdd(float x, float y, float z)
 #endif
 }
 
-float Math::Clamp(float value, float min, float max) { return Min(min, Max(value, max)); }
+float Math::Clamp(float value, float min, float max) { return Max(min, Min(value, max)); }
 float Math::Clamp01(float value) { return Clamp(value, 0, 1); }
 float Math::Lerp(float a, float b, float t) { return a + Clamp01(t) * (b - a); }
 float Math::LerpUnclamped(float a, float b, float t) { return a + t * (b - a); }
@@ -3,6 +3,7 @@
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
 #include "Math/Rect.h"
+#include "Math/SIMD.h"
 #include "Core/Assert.h"
 #include <limits>
 
@@ -119,8 +120,68 @@ bool Matrix4::operator==(const Matrix4& n) const
         V[3][0] == n.V[3][0] && V[3][1] == n.V[3][1] && V[3][2] == n.V[3][2] && V[3][3] == n.V[3][3];
 }
 
+#if GARBAGE_SIMD_SSE2
+
+FORCEINLINE static __m128 Splat(__m128 v, int index)
+{
+    switch (index)
+    {
+        case 0: return _mm_shuffle_ps(v, v, GARBAGE_SHUFFLE_MASK(0, 0, 0, 0));
+        case 1: return _mm_shuffle_ps(v, v, GARBAGE_SHUFFLE_MASK(1, 1, 1, 1));
+        case 2: return _mm_shuffle_ps(v, v, GARBAGE_SHUFFLE_MASK(2, 2, 2, 2));
+        default: return _mm_shuffle_ps(v, v, GARBAGE_SHUFFLE_MASK(3, 3, 3, 3));
+    }
+}
+
+// 2x2 matrices packed in a single register as (m00, m01, m10, m11)
+
+// A * B
+FORCEINLINE static __m128 Matrix2Multiply(__m128 a, __m128 b)
+{
+    return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, GARBAGE_SHUFFLE_MASK(0, 3, 0, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, GARBAGE_SHUFFLE_MASK(1, 0, 3, 2)), _mm_shuffle_ps(b, b, GARBAGE_SHUFFLE_MASK(2, 1, 2, 1))));
+}
+
+// Adjugate(A) * B
+FORCEINLINE static __m128 Matrix2AdjugateMultiply(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, GARBAGE_SHUFFLE_MASK(3, 3, 0, 0)), b),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, GARBAGE_SHUFFLE_MASK(1, 1, 2, 2)), _mm_shuffle_ps(b, b, GARBAGE_SHUFFLE_MASK(2, 3, 0, 1))));
+}
+
+// A * Adjugate(B)
+FORCEINLINE static __m128 Matrix2MultiplyAdjugate(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, GARBAGE_SHUFFLE_MASK(3, 0, 3, 0))),
+        _mm_mul_ps(_mm_shuffle_ps(a, a, GARBAGE_SHUFFLE_MASK(1, 0, 3, 2)), _mm_shuffle_ps(b, b, GARBAGE_SHUFFLE_MASK(2, 1, 2, 1))));
+}
+
+#endif
+
 Matrix4 Matrix4::operator*(const Matrix4& n) const
 {
+#if GARBAGE_SIMD_SSE2
+    const __m128 a0 = _mm_load_ps(V[0]);
+    const __m128 a1 = _mm_load_ps(V[1]);
+    const __m128 a2 = _mm_load_ps(V[2]);
+    const __m128 a3 = _mm_load_ps(V[3]);
+
+    Matrix4 result;
+
+    for (int i = 0; i < 4; i++)
+    {
+        const __m128 b = _mm_load_ps(n.V[i]);
+
+        __m128 column = _mm_mul_ps(a0, Splat(b, 0));
+        column = _mm_add_ps(column, _mm_mul_ps(a1, Splat(b, 1)));
+        column = _mm_add_ps(column, _mm_mul_ps(a2, Splat(b, 2)));
+        column = _mm_add_ps(column, _mm_mul_ps(a3, Splat(b, 3)));
+
+        _mm_store_ps(result.V[i], column);
+    }
+
+    return result;
+#else
     const Vector4 SrcA0 = M[0];
     const Vector4 SrcA1 = M[1];
     const Vector4 SrcA2 = M[2];
@@ -137,6 +198,7 @@ Matrix4 Matrix4::operator*(const Matrix4& n) const
     Result.M[2] = SrcA0 * SrcB2.Data[0] + SrcA1 * SrcB2.Data[1] + SrcA2 * SrcB2.Data[2] + SrcA3 * SrcB2.Data[3];
     Result.M[3] = SrcA0 * SrcB3.Data[0] + SrcA1 * SrcB3.Data[1] + SrcA2 * SrcB3.Data[2] + SrcA3 * SrcB3.Data[3];
     return Result;
+#endif
 }
 
 Vector3 Matrix4::operator*(const Vector3& v) const
@@ -146,6 +208,17 @@ Vector3 Matrix4::operator*(const Vector3& v) const
 
 Vector4 Matrix4::operator*(const Vector4& v) const
 {
+#if GARBAGE_SIMD_SSE2
+    const __m128 vector = _mm_load_ps(v.Data);
+
+    const __m128 add0 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(V[0]), Splat(vector, 0)), _mm_mul_ps(_mm_load_ps(V[1]), Splat(vector, 1)));
+    const __m128 add1 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(V[2]), Splat(vector, 2)), _mm_mul_ps(_mm_load_ps(V[3]), Splat(vector, 3)));
+
+    Vector4 result;
+    _mm_store_ps(result.Data, _mm_add_ps(add0, add1));
+
+    return result;
+#else
     const Vector4 Mov0(v.Data[0]);
     const Vector4 Mov1(v.Data[1]);
     const Vector4 Mul0 = M[0] * Mov0;
@@ -159,6 +232,7 @@ Vector4 Matrix4::operator*(const Vector4& v) const
     const Vector4 Add2 = Add0 + Add1;
 
     return Add2;
+#endif
 }
 
 Matrix4 Matrix4::operator*(float f) const
@@ -213,6 +287,61 @@ Matrix4 Matrix4::Transpose() const
 
 Matrix4 Matrix4::Inverse() const
 {
+#if GARBAGE_SIMD_SSE2
+    // Block-wise inversion, the matrix is split into 2x2 blocks
+    // | A B |
+    // | C D |
+    const __m128 v0 = _mm_load_ps(V[0]);
+    const __m128 v1 = _mm_load_ps(V[1]);
+    const __m128 v2 = _mm_load_ps(V[2]);
+    const __m128 v3 = _mm_load_ps(V[3]);
+
+    const __m128 a = _mm_movelh_ps(v0, v1);
+    const __m128 b = _mm_movehl_ps(v1, v0);
+    const __m128 c = _mm_movelh_ps(v2, v3);
+    const __m128 d = _mm_movehl_ps(v3, v2);
+
+    // (|A|, |B|, |C|, |D|)
+    const __m128 determinants = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(v0, v2, GARBAGE_SHUFFLE_MASK(0, 2, 0, 2)), _mm_shuffle_ps(v1, v3, GARBAGE_SHUFFLE_MASK(1, 3, 1, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(v0, v2, GARBAGE_SHUFFLE_MASK(1, 3, 1, 3)), _mm_shuffle_ps(v1, v3, GARBAGE_SHUFFLE_MASK(0, 2, 0, 2))));
+
+    const __m128 detA = Splat(determinants, 0);
+    const __m128 detB = Splat(determinants, 1);
+    const __m128 detC = Splat(determinants, 2);
+    const __m128 detD = Splat(determinants, 3);
+
+    const __m128 dc = Matrix2AdjugateMultiply(d, c);
+    const __m128 ab = Matrix2AdjugateMultiply(a, b);
+
+    // Adjugates of the result blocks
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Matrix2Multiply(b, dc));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Matrix2Multiply(c, ab));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Matrix2MultiplyAdjugate(d, ab));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Matrix2MultiplyAdjugate(a, dc));
+
+    // |M| = |A| * |D| + |B| * |C| - trace(Adjugate(A) * B * Adjugate(D) * C)
+    __m128 trace = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, GARBAGE_SHUFFLE_MASK(0, 2, 1, 3)));
+    trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, GARBAGE_SHUFFLE_MASK(2, 3, 0, 1)));
+    trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, GARBAGE_SHUFFLE_MASK(1, 0, 3, 2)));
+
+    const __m128 determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+    const __m128 inverseDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+
+    x = _mm_mul_ps(x, inverseDeterminant);
+    y = _mm_mul_ps(y, inverseDeterminant);
+    z = _mm_mul_ps(z, inverseDeterminant);
+    w = _mm_mul_ps(w, inverseDeterminant);
+
+    // Adjugate shuffle of every block is merged with the store shuffle
+    Matrix4 result;
+    _mm_store_ps(result.V[0], _mm_shuffle_ps(x, y, GARBAGE_SHUFFLE_MASK(3, 1, 3, 1)));
+    _mm_store_ps(result.V[1], _mm_shuffle_ps(x, y, GARBAGE_SHUFFLE_MASK(2, 0, 2, 0)));
+    _mm_store_ps(result.V[2], _mm_shuffle_ps(z, w, GARBAGE_SHUFFLE_MASK(3, 1, 3, 1)));
+    _mm_store_ps(result.V[3], _mm_shuffle_ps(z, w, GARBAGE_SHUFFLE_MASK(2, 0, 2, 0)));
+
+    return result;
+#else
     int indxc[4], indxr[4];
     int ipiv[4] = { 0, 0, 0, 0 };
     float minv[4][4];
@@ -239,7 +368,7 @@ Matrix4 Matrix4::Inverse() const
                 {
                     if (ipiv[k] == 0)
                     {
-                        float abs = minv[j][k];
+                        float abs = Math::Abs(minv[j][k]);
                         if (abs >= big)
                         {
                             big = abs;
@@ -298,6 +427,7 @@ Matrix4 Matrix4::Inverse() const
         }
     }
     return Matrix4(minv);
+#endif
 }
 
 void Matrix4::SetAllValues(float a1, float a2, float a3, float a4,
@@ -488,4 +618,74 @@ Vector3 Matrix4::Project(const Vector3& vec, const Matrix4& view, const Matrix4&
         viewport.Position.Y + viewport.Size.Y * (v.Y + 1.0f) / 2.0f,
         (v.Z + 1.0f) / 2.0f
     );
+}
+
+#if !GARBAGE_SIMD_SSE2
+
+static void TransformPointsScalar(const Matrix4& matrix, const Vector2* in, Vector4* out, uint64 count)
+{
+    for (uint64 i = 0; i < count; i++)
+    {
+        out[i] = matrix.M[0] * in[i].X + matrix.M[1] * in[i].Y + matrix.M[3];
+    }
+}
+
+#else
+
+static void TransformPointsSSE2(const Matrix4& matrix, const Vector2* in, Vector4* out, uint64 count)
+{
+    const __m128 column0 = _mm_load_ps(matrix.V[0]);
+    const __m128 column1 = _mm_load_ps(matrix.V[1]);
+    const __m128 column3 = _mm_load_ps(matrix.V[3]);
+
+    for (uint64 i = 0; i < count; i++)
+    {
+        const __m128 x = _mm_set1_ps(in[i].X);
+        const __m128 y = _mm_set1_ps(in[i].Y);
+
+        _mm_storeu_ps(out[i].Data, _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, x), _mm_mul_ps(column1, y)), column3));
+    }
+}
+
+// Four points per iteration, every 256 bit register holds two output vectors
+GARBAGE_TARGET_AVX2 static void TransformPointsAVX2(const Matrix4& matrix, const Vector2* in, Vector4* out, uint64 count)
+{
+    const __m256 column0 = _mm256_broadcast_ps((const __m128*)matrix.V[0]);
+    const __m256 column1 = _mm256_broadcast_ps((const __m128*)matrix.V[1]);
+    const __m256 column3 = _mm256_broadcast_ps((const __m128*)matrix.V[3]);
+
+    const __m256i x01 = _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2);
+    const __m256i y01 = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+    const __m256i x23 = _mm256_setr_epi32(4, 4, 4, 4, 6, 6, 6, 6);
+    const __m256i y23 = _mm256_setr_epi32(5, 5, 5, 5, 7, 7, 7, 7);
+
+    uint64 i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256 points = _mm256_loadu_ps(in[i].Data);
+
+        const __m256 result01 = _mm256_add_ps(_mm256_add_ps(
+            _mm256_mul_ps(column0, _mm256_permutevar8x32_ps(points, x01)),
+            _mm256_mul_ps(column1, _mm256_permutevar8x32_ps(points, y01))), column3);
+        const __m256 result23 = _mm256_add_ps(_mm256_add_ps(
+            _mm256_mul_ps(column0, _mm256_permutevar8x32_ps(points, x23)),
+            _mm256_mul_ps(column1, _mm256_permutevar8x32_ps(points, y23))), column3);
+
+        _mm256_storeu_ps(out[i].Data, result01);
+        _mm256_storeu_ps(out[i + 2].Data, result23);
+    }
+
+    TransformPointsSSE2(matrix, in + i, out + i, count - i);
+}
+
+#endif
+
+void TransformPoints(const Matrix4& matrix, const Vector2* in, Vector4* out, uint64 count)
+{
+#if GARBAGE_SIMD_SSE2
+    if (SIMD::IsAVX2Supported()) TransformPointsAVX2(matrix, in, out, count);
+    else TransformPointsSSE2(matrix, in, out, count);
+#else
+    TransformPointsScalar(matrix, in, out, count);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "Math/SIMD.h"
+
+#if GARBAGE_SIMD_SSE2 && COMPILER == COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+static bool DetectAVX2()
+{
+#if !GARBAGE_SIMD_SSE2
+	return false;
+#elif COMPILER == COMPILER_MSVC
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+
+	// OSXSAVE and AVX
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+
+	// OS must save YMM registers on context switch
+	if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+namespace SIMD
+{
+
+	bool IsAVX2Supported()
+	{
+		static const bool supported = DetectAVX2();
+		return supported;
+	}
+
+}
\ No newline at end of file
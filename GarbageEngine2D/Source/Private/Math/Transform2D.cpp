@@ -0,0 +1,106 @@
+#include "Math/Transform2D.h"
+#include "Math/Matrix4.h"
+#include "Math/Math.h"
+#include "Math/SIMD.h"
+
+GARBAGE_API const Transform2D Transform2D::Identity = Transform2D();
+
+Transform2D::Transform2D(const Vector2& position, float rotation, const Vector2& scale)
+{
+	const float sin = Math::Sin(rotation);
+	const float cos = Math::Cos(rotation);
+
+	AxisX = Vector2(cos * scale.X, sin * scale.X);
+	AxisY = Vector2(-sin * scale.Y, cos * scale.Y);
+	Translation = position;
+}
+
+Transform2D Transform2D::FromMatrix4(const Matrix4& matrix)
+{
+	return Transform2D(Vector2(matrix.V[0][0], matrix.V[0][1]), Vector2(matrix.V[1][0], matrix.V[1][1]), Vector2(matrix.V[3][0], matrix.V[3][1]));
+}
+
+Matrix4 Transform2D::ToMatrix4() const
+{
+	return Matrix4(
+		AxisX.X, AxisX.Y, 0.0f, 0.0f,
+		AxisY.X, AxisY.Y, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		Translation.X, Translation.Y, 0.0f, 1.0f);
+}
+
+Transform2D Transform2D::operator*(const Transform2D& other) const
+{
+	return Transform2D(TransformVector(other.AxisX), TransformVector(other.AxisY), TransformPoint(other.Translation));
+}
+
+Transform2D& Transform2D::operator*=(const Transform2D& other)
+{
+	*this = *this * other;
+	return *this;
+}
+
+bool Transform2D::operator==(const Transform2D& other) const
+{
+	return AxisX.X == other.AxisX.X && AxisX.Y == other.AxisX.Y
+		&& AxisY.X == other.AxisY.X && AxisY.Y == other.AxisY.Y
+		&& Translation.X == other.Translation.X && Translation.Y == other.Translation.Y;
+}
+
+void Transform2D::TransformPoints(const Vector2* in, Vector2* out, uint64 count) const
+{
+	uint64 i = 0;
+
+#if GARBAGE_SIMD_SSE2
+	// Two points per register
+	const __m128 axisX = _mm_setr_ps(AxisX.X, AxisX.Y, AxisX.X, AxisX.Y);
+	const __m128 axisY = _mm_setr_ps(AxisY.X, AxisY.Y, AxisY.X, AxisY.Y);
+	const __m128 translation = _mm_setr_ps(Translation.X, Translation.Y, Translation.X, Translation.Y);
+
+	for (; i + 2 <= count; i += 2)
+	{
+		const __m128 points = _mm_loadu_ps(in[i].Data);
+		const __m128 x = _mm_shuffle_ps(points, points, GARBAGE_SHUFFLE_MASK(0, 0, 2, 2));
+		const __m128 y = _mm_shuffle_ps(points, points, GARBAGE_SHUFFLE_MASK(1, 1, 3, 3));
+
+		_mm_storeu_ps(out[i].Data, _mm_add_ps(_mm_add_ps(_mm_mul_ps(axisX, x), _mm_mul_ps(axisY, y)), translation));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		out[i] = TransformPoint(in[i]);
+	}
+}
+
+Transform2D Transform2D::Inverse() const
+{
+	const float determinant = GetDeterminant();
+	if (determinant == 0.0f) return Transform2D(Vector2(0.0f, 0.0f), Vector2(0.0f, 0.0f), Vector2(0.0f, 0.0f));
+
+	const float inverseDeterminant = 1.0f / determinant;
+
+	Transform2D result(
+		Vector2(AxisY.Y * inverseDeterminant, -AxisX.Y * inverseDeterminant),
+		Vector2(-AxisY.X * inverseDeterminant, AxisX.X * inverseDeterminant),
+		Vector2(0.0f, 0.0f));
+
+	const Vector2 translation = result.TransformVector(Translation);
+	result.Translation = Vector2(-translation.X, -translation.Y);
+
+	return result;
+}
+
+float Transform2D::GetRotation() const
+{
+	return Math::Atan2(AxisX.Y, AxisX.X);
+}
+
+Vector2 Transform2D::GetScale() const
+{
+	const float scaleX = Math::Sqrt(AxisX.X * AxisX.X + AxisX.Y * AxisX.Y);
+	const float scaleY = Math::Sqrt(AxisY.X * AxisY.X + AxisY.Y * AxisY.Y);
+
+	// Mirrored transforms keep the sign on Y
+	return Vector2(scaleX, GetDeterminant() < 0.0f ? -scaleY : scaleY);
+}
\ No newline at end of file
@@ -1,53 +1,173 @@
 #include "Memory/ArenaAllocator.h"
-#include "Math/Math.h"
+#include "Core/Assert.h"
+#include "Memory/Statistics.h"
+#include <algorithm>
 #include <cstdlib>
 
-ArenaAllocator::ArenaAllocator(uint64 size) : m_capacity(size)
+FORCEINLINE static uint64 AlignUp(uint64 value, uint64 alignment)
 {
-	m_bytes = std::calloc(1, size);
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+ArenaAllocator::ArenaAllocator(uint64 chunkSize) : m_chunkSize(chunkSize)
+{
+	m_firstChunk = m_currentChunk = CreateChunk(chunkSize);
 }
 
 ArenaAllocator::~ArenaAllocator()
 {
-	std::free(m_bytes);
+	Reset();
+
+	MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Allocators, m_firstChunk->Size);
+	std::free(m_firstChunk);
+
+	while (m_freeChunks)
+	{
+		Chunk* chunk = m_freeChunks;
+		m_freeChunks = chunk->Previous;
+
+		MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Allocators, chunk->Size);
+		std::free(chunk);
+	}
 }
 
-void* ArenaAllocator::Allocate(uint64 size)
+void* ArenaAllocator::Allocate(uint64 size, uint64 alignment)
 {
-	uint64 current = Current();
+	GARBAGE_CORE_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two, got {}", alignment);
+
+	uint64 data = (uint64)GetChunkData(m_currentChunk);
+	uint64 address = AlignUp(data + m_currentChunk->Used, alignment);
 
-	if (m_bytesWritten + size > m_capacity)
+	if (address + size > data + m_currentChunk->Size)
 	{
-		m_capacity += size;
-		m_capacity = Math::Ceil((float)m_capacity * 1.5f);
-		m_bytes = std::realloc(m_bytes, m_capacity);
+		AddChunk(size + alignment - 1);
 
-		std::memset((void*)((uint64)m_bytes + m_bytesWritten), 0, m_capacity - m_bytesWritten);
+		data = (uint64)GetChunkData(m_currentChunk);
+		address = AlignUp(data, alignment);
 	}
 
-	m_bytesWritten += size;
+	m_currentChunk->Used = address + size - data;
+	m_length += size;
+	m_peakBytes = std::max(m_peakBytes, m_retiredBytes + m_currentChunk->Used);
 
-	return (void*)current;
+	return (void*)address;
+}
+
+void ArenaAllocator::RegisterDestructor(void* object, Destructor destructor)
+{
+	auto node = (DestructorNode*)Allocate(sizeof(DestructorNode), alignof(DestructorNode));
+	node->Previous = m_destructors;
+	node->Object = object;
+	node->Function = destructor;
+
+	m_destructors = node;
 }
 
 uint64 ArenaAllocator::Current() const
 {
-	return (uint64)m_bytes + m_bytesWritten;
+	return (uint64)GetChunkData(m_currentChunk) + m_currentChunk->Used;
 }
 
 uint64 ArenaAllocator::Length() const
 {
-	return m_bytesWritten;
+	return m_length;
 }
 
 void ArenaAllocator::Reserve(uint64 size)
 {
-	m_capacity += size;
-	m_bytes = std::realloc(m_bytes, m_capacity);
+	if (m_currentChunk->Used + size > m_currentChunk->Size) AddChunk(size);
+}
+
+ArenaAllocator::Marker ArenaAllocator::GetMarker() const
+{
+	return { m_currentChunk, m_currentChunk->Used, m_destructors, m_length, m_retiredBytes };
+}
+
+void ArenaAllocator::RewindTo(const Marker& marker)
+{
+	while (m_destructors != marker.Destructors)
+	{
+		GARBAGE_CORE_ASSERT(m_destructors, "Marker does not belong to this arena or was already rewound");
+
+		DestructorNode* node = m_destructors;
+		m_destructors = node->Previous;
+		node->Function(node->Object);
+	}
+
+	while (m_currentChunk != marker.Chunk)
+	{
+		GARBAGE_CORE_ASSERT(m_currentChunk != m_firstChunk, "Marker does not belong to this arena or was already rewound");
+
+		Chunk* chunk = m_currentChunk;
+		m_currentChunk = chunk->Previous;
+		ReleaseChunk(chunk);
+	}
+
+	MemoryStatistics::UntagRange(GetChunkData(m_currentChunk) + marker.ChunkUsed, GetChunkData(m_currentChunk) + m_currentChunk->Used);
+
+	m_currentChunk->Used = marker.ChunkUsed;
+	m_length = marker.Length;
+	m_retiredBytes = marker.RetiredBytes;
 }
 
 void ArenaAllocator::Reset()
 {
-	m_bytes = std::calloc(1, m_capacity);
-	m_bytesWritten = 0;
+	RewindTo({ m_firstChunk, 0, nullptr, 0, 0 });
+}
+
+uint64 ArenaAllocator::GetWastedBytes() const
+{
+	return m_retiredBytes + m_currentChunk->Used - m_length;
+}
+
+ArenaAllocator::Chunk* ArenaAllocator::CreateChunk(uint64 size)
+{
+	auto chunk = (Chunk*)std::malloc(sizeof(Chunk) + size);
+	GARBAGE_CORE_ASSERT(chunk, "Failed to allocate arena chunk of {} bytes", size);
+
+	chunk->Previous = nullptr;
+	chunk->Size = size;
+	chunk->Used = 0;
+
+	m_numberOfChunks++;
+	MemoryStatistics::Allocated(MemoryDomain::CPU, MemoryCategory::Allocators, size);
+
+	return chunk;
+}
+
+void ArenaAllocator::AddChunk(uint64 minimumSize)
+{
+	Chunk* chunk = nullptr;
+
+	if (minimumSize <= m_chunkSize && m_freeChunks)
+	{
+		chunk = m_freeChunks;
+		m_freeChunks = chunk->Previous;
+		chunk->Used = 0;
+	}
+	else
+	{
+		chunk = CreateChunk(std::max(minimumSize, m_chunkSize));
+	}
+
+	m_retiredBytes += m_currentChunk->Size;
+
+	chunk->Previous = m_currentChunk;
+	m_currentChunk = chunk;
 }
+
+void ArenaAllocator::ReleaseChunk(Chunk* chunk)
+{
+	MemoryStatistics::UntagRange(GetChunkData(chunk), GetChunkData(chunk) + chunk->Used);
+
+	if (chunk->Size == m_chunkSize)
+	{
+		chunk->Previous = m_freeChunks;
+		m_freeChunks = chunk;
+		return;
+	}
+
+	MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Allocators, chunk->Size);
+	std::free(chunk);
+	m_numberOfChunks--;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "Memory/FrameAllocator.h"
+#include "Core/Assert.h"
+
+FrameAllocator::FrameAllocator(uint32 numberOfFrames, uint64 chunkSize)
+{
+	GARBAGE_CORE_ASSERT(numberOfFrames > 0, "Frame allocator needs at least one frame");
+
+	m_frames.reserve(numberOfFrames);
+	for (uint32 i = 0; i < numberOfFrames; i++)
+	{
+		m_frames.push_back(MakeScope<ArenaAllocator>(chunkSize));
+	}
+}
+
+void* FrameAllocator::Allocate(uint64 size, uint64 alignment)
+{
+	return m_frames[m_currentFrame]->Allocate(size, alignment);
+}
+
+void FrameAllocator::RegisterDestructor(void* object, Destructor destructor)
+{
+	m_frames[m_currentFrame]->RegisterDestructor(object, destructor);
+}
+
+uint64 FrameAllocator::Current() const
+{
+	return m_frames[m_currentFrame]->Current();
+}
+
+uint64 FrameAllocator::Length() const
+{
+	return m_frames[m_currentFrame]->Length();
+}
+
+void FrameAllocator::Reserve(uint64 size)
+{
+	m_frames[m_currentFrame]->Reserve(size);
+}
+
+void FrameAllocator::NextFrame()
+{
+	m_currentFrame = (m_currentFrame + 1) % (uint32)m_frames.size();
+	m_frames[m_currentFrame]->Reset();
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "Memory/PoolAllocator.h"
+#include "Core/Assert.h"
+#include "Memory/Statistics.h"
+#include <algorithm>
+#include <new>
+
+static std::atomic<uint64> s_nextPoolId{ 1 };
+
+// Pools with thread caches. Ids are never reused, so a cache whose pool is not here belongs to a destroyed pool
+static std::mutex s_cachedPoolsMutex;
+static std::vector<PoolAllocator*> s_cachedPools;
+// Changes whenever a pool with thread caches is destroyed, threads then drop caches of dead pools
+static std::atomic<uint64> s_cachedPoolsEpoch{ 0 };
+
+struct PoolAllocator::ThreadCaches
+{
+	ThreadCache Caches[MaxThreadCaches]{};
+	uint64 Epoch{ 0 };
+
+	~ThreadCaches()
+	{
+		std::scoped_lock<std::mutex> lock(s_cachedPoolsMutex);
+
+		for (auto& cache : Caches)
+		{
+			PoolAllocator* pool = FindPool(cache.PoolId);
+			if (!pool) continue;
+
+			for (uint8 i = 0; i < NumberOfSizeClasses; i++) pool->FlushThreadCache(cache, i, cache.Counts[i]);
+		}
+	}
+
+	// Blocks of a destroyed pool were freed with its pages, so its caches are only forgotten
+	void DropStaleCaches()
+	{
+		const uint64 epoch = s_cachedPoolsEpoch.load(std::memory_order_acquire);
+		if (epoch == Epoch) return;
+
+		std::scoped_lock<std::mutex> lock(s_cachedPoolsMutex);
+
+		for (auto& cache : Caches)
+		{
+			if (cache.PoolId != 0 && !FindPool(cache.PoolId)) cache = ThreadCache();
+		}
+
+		Epoch = epoch;
+	}
+
+	// Must be called with s_cachedPoolsMutex held
+	static PoolAllocator* FindPool(uint64 id)
+	{
+		if (id == 0) return nullptr;
+
+		auto it = std::find_if(s_cachedPools.begin(), s_cachedPools.end(), [id](const PoolAllocator* pool) { return pool->m_id == id; });
+		return it != s_cachedPools.end() ? *it : nullptr;
+	}
+};
+
+static constexpr std::array<uint8, PoolAllocator::MaxBlockSize / 16 + 1> MakeSizeClassLookup()
+{
+	std::array<uint8, PoolAllocator::MaxBlockSize / 16 + 1> lookup{};
+
+	uint8 sizeClass = 0;
+	for (uint64 i = 0; i < lookup.size(); i++)
+	{
+		while (PoolAllocator::SizeClasses[sizeClass] < i * 16) sizeClass++;
+		lookup[i] = sizeClass;
+	}
+
+	return lookup;
+}
+
+static constexpr auto s_sizeClassLookup = MakeSizeClassLookup();
+
+PoolAllocator::PoolAllocator(const Specification& specification) : m_specification(specification), m_id(s_nextPoolId.fetch_add(1))
+{
+	GARBAGE_CORE_ASSERT(specification.PageSize >= MaxBlockSize, "Pool page size must be at least {} bytes", MaxBlockSize);
+
+	if (m_specification.ThreadLocalCaches)
+	{
+		std::scoped_lock<std::mutex> lock(s_cachedPoolsMutex);
+		s_cachedPools.push_back(this);
+	}
+}
+
+PoolAllocator::~PoolAllocator()
+{
+	if (m_specification.ThreadLocalCaches)
+	{
+		std::scoped_lock<std::mutex> lock(s_cachedPoolsMutex);
+		s_cachedPools.erase(std::find(s_cachedPools.begin(), s_cachedPools.end(), this));
+		s_cachedPoolsEpoch.fetch_add(1, std::memory_order_release);
+	}
+
+	for (void* page : m_pages)
+	{
+		::operator delete(page, std::align_val_t(PageAlignment));
+		MemoryStatistics::Freed(MemoryDomain::CPU, MemoryCategory::Allocators, m_specification.PageSize);
+	}
+}
+
+void* PoolAllocator::Allocate(uint64 size, uint64 alignment)
+{
+	const uint8 sizeClass = GetSizeClass(size, alignment);
+
+	if (sizeClass == LargeAllocation) return ::operator new(size, std::align_val_t(alignment));
+
+	const uint64 bytesInUse = m_bytesInUse.fetch_add(SizeClasses[sizeClass], std::memory_order_relaxed) + SizeClasses[sizeClass];
+
+	uint64 peak = m_peakBytesInUse.load(std::memory_order_relaxed);
+	while (bytesInUse > peak && !m_peakBytesInUse.compare_exchange_weak(peak, bytesInUse, std::memory_order_relaxed)) {}
+
+	if (m_specification.ThreadLocalCaches)
+	{
+		if (ThreadCache* cache = FindThreadCache())
+		{
+			if (!cache->Blocks[sizeClass]) RefillThreadCache(*cache, sizeClass);
+
+			FreeBlock* block = cache->Blocks[sizeClass];
+			cache->Blocks[sizeClass] = block->Next;
+			cache->Counts[sizeClass]--;
+
+			return block;
+		}
+	}
+
+	auto lock = Lock();
+	return PopFreeBlock(sizeClass);
+}
+
+void PoolAllocator::Deallocate(void* pointer, uint64 size, uint64 alignment)
+{
+	if (!pointer) return;
+
+	const uint8 sizeClass = GetSizeClass(size, alignment);
+
+	if (sizeClass == LargeAllocation)
+	{
+		::operator delete(pointer, std::align_val_t(alignment));
+		return;
+	}
+
+	m_bytesInUse.fetch_sub(SizeClasses[sizeClass], std::memory_order_relaxed);
+
+	FreeBlock* block = (FreeBlock*)pointer;
+
+	if (m_specification.ThreadLocalCaches)
+	{
+		if (ThreadCache* cache = FindThreadCache())
+		{
+			block->Next = cache->Blocks[sizeClass];
+			cache->Blocks[sizeClass] = block;
+
+			if (++cache->Counts[sizeClass] >= 2 * ThreadCacheBatchSize) FlushThreadCache(*cache, sizeClass, ThreadCacheBatchSize);
+			return;
+		}
+	}
+
+	auto lock = Lock();
+	block->Next = m_freeLists[sizeClass];
+	m_freeLists[sizeClass] = block;
+}
+
+uint64 PoolAllocator::Current() const
+{
+	return GetNumberOfPages() * m_specification.PageSize;
+}
+
+uint64 PoolAllocator::Length() const
+{
+	return m_bytesInUse.load(std::memory_order_relaxed);
+}
+
+void PoolAllocator::Reserve(uint64 size)
+{
+	const uint8 sizeClass = GetSizeClass(size, alignof(std::max_align_t));
+	if (sizeClass == LargeAllocation) return;
+
+	auto lock = Lock();
+	if (!m_freeLists[sizeClass]) AllocatePage(sizeClass);
+}
+
+uint64 PoolAllocator::GetNumberOfPages() const
+{
+	auto lock = Lock();
+	return m_pages.size();
+}
+
+uint8 PoolAllocator::GetSizeClass(uint64 size, uint64 alignment)
+{
+	if (size > MaxBlockSize || alignment > PageAlignment) return LargeAllocation;
+
+	// Blocks are placed at multiples of their size from an aligned page start
+	uint8 sizeClass = s_sizeClassLookup[(size + 15) >> 4];
+	while (sizeClass < NumberOfSizeClasses && SizeClasses[sizeClass] % alignment != 0) sizeClass++;
+
+	return sizeClass < NumberOfSizeClasses ? sizeClass : LargeAllocation;
+}
+
+std::unique_lock<std::mutex> PoolAllocator::Lock() const
+{
+	return m_specification.ThreadSafe ? std::unique_lock<std::mutex>(m_mutex) : std::unique_lock<std::mutex>();
+}
+
+PoolAllocator::FreeBlock* PoolAllocator::PopFreeBlock(uint8 sizeClass)
+{
+	if (!m_freeLists[sizeClass]) AllocatePage(sizeClass);
+
+	FreeBlock* block = m_freeLists[sizeClass];
+	m_freeLists[sizeClass] = block->Next;
+
+	return block;
+}
+
+void PoolAllocator::AllocatePage(uint8 sizeClass)
+{
+	uint8* page = (uint8*)::operator new(m_specification.PageSize, std::align_val_t(PageAlignment));
+	m_pages.push_back(page);
+
+	MemoryStatistics::Allocated(MemoryDomain::CPU, MemoryCategory::Allocators, m_specification.PageSize);
+
+	const uint64 blockSize = SizeClasses[sizeClass];
+	const uint64 numberOfBlocks = m_specification.PageSize / blockSize;
+
+	// Link blocks back to front, so they are handed out in address order
+	for (uint64 i = numberOfBlocks; i-- > 0;)
+	{
+		FreeBlock* block = (FreeBlock*)(page + i * blockSize);
+		block->Next = m_freeLists[sizeClass];
+		m_freeLists[sizeClass] = block;
+	}
+}
+
+PoolAllocator::ThreadCache* PoolAllocator::FindThreadCache() const
+{
+	static thread_local ThreadCaches caches;
+
+	for (auto& cache : caches.Caches)
+	{
+		if (cache.PoolId == m_id) return &cache;
+	}
+
+	caches.DropStaleCaches();
+
+	for (auto& cache : caches.Caches)
+	{
+		if (cache.PoolId == 0)
+		{
+			cache.PoolId = m_id;
+			return &cache;
+		}
+	}
+
+	return nullptr;
+}
+
+void PoolAllocator::RefillThreadCache(ThreadCache& cache, uint8 sizeClass)
+{
+	auto lock = Lock();
+
+	for (uint32 i = 0; i < ThreadCacheBatchSize; i++)
+	{
+		FreeBlock* block = PopFreeBlock(sizeClass);
+		block->Next = cache.Blocks[sizeClass];
+		cache.Blocks[sizeClass] = block;
+	}
+
+	cache.Counts[sizeClass] += ThreadCacheBatchSize;
+}
+
+void PoolAllocator::FlushThreadCache(ThreadCache& cache, uint8 sizeClass, uint32 count)
+{
+	auto lock = Lock();
+
+	for (uint32 i = 0; i < count && cache.Blocks[sizeClass]; i++)
+	{
+		FreeBlock* block = cache.Blocks[sizeClass];
+		cache.Blocks[sizeClass] = block->Next;
+		cache.Counts[sizeClass]--;
+
+		block->Next = m_freeLists[sizeClass];
+		m_freeLists[sizeClass] = block;
+	}
+}
\ No newline at end of file
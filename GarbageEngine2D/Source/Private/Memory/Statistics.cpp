@@ -1,7 +1,247 @@
 #include "Memory/Statistics.h"
+#include "Core/Log.h"
+#include "Core/Utils.h"
+#include <algorithm>
+#include <unordered_map>
+
+const char* MemoryDomainToString(MemoryDomain domain)
+{
+	switch (domain)
+	{
+		case MemoryDomain::CPU: return "CPU";
+		case MemoryDomain::GPU: return "GPU";
+		default: return "Unknown";
+	}
+}
+
+const char* MemoryCategoryToString(MemoryCategory category)
+{
+	switch (category)
+	{
+		case MemoryCategory::Textures: return "Textures";
+		case MemoryCategory::VertexBuffers: return "VertexBuffers";
+		case MemoryCategory::IndexBuffers: return "IndexBuffers";
+		case MemoryCategory::Framebuffers: return "Framebuffers";
+		case MemoryCategory::Assets: return "Assets";
+		case MemoryCategory::Reflection: return "Reflection";
+		case MemoryCategory::Allocators: return "Allocators";
+		case MemoryCategory::Other: return "Other";
+		default: return "Unknown";
+	}
+}
+
+uint64 MemoryStatistics::Snapshot::GetTotal(MemoryDomain domain) const
+{
+	uint64 total = 0;
+	for (auto& counter : Counters[(uint8)domain]) total += counter.Current;
+
+	return total;
+}
 
 MemoryStatistics& MemoryStatistics::Get()
 {
 	static MemoryStatistics instance;
 	return instance;
 }
+
+void MemoryStatistics::Allocated(MemoryDomain domain, MemoryCategory category, uint64 size)
+{
+	AtomicCounter& counter = GetAtomicCounter(domain, category);
+
+	const uint64 current = counter.Current.fetch_add(size, std::memory_order_relaxed) + size;
+	counter.NumberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	uint64 peak = counter.Peak.load(std::memory_order_relaxed);
+	while (current > peak && !counter.Peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+}
+
+void MemoryStatistics::Freed(MemoryDomain domain, MemoryCategory category, uint64 size)
+{
+	AtomicCounter& counter = GetAtomicCounter(domain, category);
+
+	counter.Current.fetch_sub(size, std::memory_order_relaxed);
+	counter.NumberOfAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryStatistics::Resized(MemoryDomain domain, MemoryCategory category, uint64 oldSize, uint64 newSize)
+{
+	AtomicCounter& counter = GetAtomicCounter(domain, category);
+
+	if (oldSize == 0 && newSize != 0) counter.NumberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+	else if (oldSize != 0 && newSize == 0) counter.NumberOfAllocations.fetch_sub(1, std::memory_order_relaxed);
+
+	const uint64 current = counter.Current.fetch_add(newSize - oldSize, std::memory_order_relaxed) + newSize - oldSize;
+
+	uint64 peak = counter.Peak.load(std::memory_order_relaxed);
+	while (current > peak && !counter.Peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+}
+
+MemoryStatistics::Counter MemoryStatistics::GetCounter(MemoryDomain domain, MemoryCategory category)
+{
+	AtomicCounter& counter = GetAtomicCounter(domain, category);
+
+	Counter result;
+	result.Current = counter.Current.load(std::memory_order_relaxed);
+	result.Peak = counter.Peak.load(std::memory_order_relaxed);
+	result.NumberOfAllocations = counter.NumberOfAllocations.load(std::memory_order_relaxed);
+
+	return result;
+}
+
+uint64 MemoryStatistics::GetTotal(MemoryDomain domain)
+{
+	uint64 total = 0;
+	for (uint8 category = 0; category < (uint8)MemoryCategory::Count; category++)
+	{
+		total += GetAtomicCounter(domain, (MemoryCategory)category).Current.load(std::memory_order_relaxed);
+	}
+
+	return total;
+}
+
+void MemoryStatistics::ResetPeaks()
+{
+	for (auto& counters : Get().m_counters)
+	{
+		for (auto& counter : counters)
+		{
+			counter.Peak.store(counter.Current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+}
+
+MemoryStatistics::Snapshot MemoryStatistics::TakeSnapshot()
+{
+	Snapshot snapshot;
+	snapshot.FrameIndex = Get().m_frameIndex;
+
+	for (uint8 domain = 0; domain < (uint8)MemoryDomain::Count; domain++)
+	{
+		for (uint8 category = 0; category < (uint8)MemoryCategory::Count; category++)
+		{
+			snapshot.Counters[domain][category] = GetCounter((MemoryDomain)domain, (MemoryCategory)category);
+		}
+	}
+
+	return snapshot;
+}
+
+void MemoryStatistics::CaptureFrame()
+{
+	MemoryStatistics& statistics = Get();
+	Snapshot snapshot = TakeSnapshot();
+
+	std::scoped_lock<std::mutex> lock(statistics.m_historyMutex);
+
+	if (statistics.m_history.size() < MaxFrameHistory)
+	{
+		statistics.m_history.push_back(snapshot);
+	}
+	else
+	{
+		statistics.m_history[statistics.m_historyStart] = snapshot;
+		statistics.m_historyStart = (statistics.m_historyStart + 1) % MaxFrameHistory;
+	}
+
+	statistics.m_frameIndex++;
+}
+
+uint64 MemoryStatistics::GetNumberOfCapturedFrames()
+{
+	std::scoped_lock<std::mutex> lock(Get().m_historyMutex);
+	return Get().m_history.size();
+}
+
+MemoryStatistics::Snapshot MemoryStatistics::GetCapturedFrame(uint64 index)
+{
+	MemoryStatistics& statistics = Get();
+
+	std::scoped_lock<std::mutex> lock(statistics.m_historyMutex);
+	return statistics.m_history[(statistics.m_historyStart + index) % statistics.m_history.size()];
+}
+
+void MemoryStatistics::SetTaggingEnabled(bool enabled)
+{
+	MemoryStatistics& statistics = Get();
+	statistics.m_taggingEnabled.store(enabled, std::memory_order_relaxed);
+
+	if (!enabled)
+	{
+		std::scoped_lock<std::mutex> lock(statistics.m_tagsMutex);
+		statistics.m_tags.clear();
+	}
+}
+
+void* MemoryStatistics::TagAllocation(void* pointer, uint64 size, const char* file, uint32 line)
+{
+	if (!pointer || !IsTaggingEnabled()) return pointer;
+
+	MemoryStatistics& statistics = Get();
+
+	std::scoped_lock<std::mutex> lock(statistics.m_tagsMutex);
+	statistics.m_tags[pointer] = { size, file, line };
+
+	return pointer;
+}
+
+void MemoryStatistics::UntagAllocation(const void* pointer)
+{
+	if (!IsTaggingEnabled()) return;
+
+	MemoryStatistics& statistics = Get();
+
+	std::scoped_lock<std::mutex> lock(statistics.m_tagsMutex);
+	statistics.m_tags.erase(pointer);
+}
+
+void MemoryStatistics::UntagRange(const void* begin, const void* end)
+{
+	if (!IsTaggingEnabled()) return;
+
+	MemoryStatistics& statistics = Get();
+
+	std::scoped_lock<std::mutex> lock(statistics.m_tagsMutex);
+	statistics.m_tags.erase(statistics.m_tags.lower_bound(begin), statistics.m_tags.lower_bound(end));
+}
+
+std::vector<MemoryStatistics::AllocationSite> MemoryStatistics::GetLiveAllocationSites()
+{
+	MemoryStatistics& statistics = Get();
+
+	// File names come from __FILE__, so call sites can be keyed by pointer
+	std::unordered_map<const char*, std::unordered_map<uint32, AllocationSite>> sites;
+
+	{
+		std::scoped_lock<std::mutex> lock(statistics.m_tagsMutex);
+
+		for (auto& [pointer, tag] : statistics.m_tags)
+		{
+			AllocationSite& site = sites[tag.File].try_emplace(tag.Line, AllocationSite{ tag.File, tag.Line, 0, 0 }).first->second;
+			site.Bytes += tag.Size;
+			site.NumberOfAllocations++;
+		}
+	}
+
+	std::vector<AllocationSite> result;
+	for (auto& [file, lines] : sites)
+	{
+		for (auto& [line, site] : lines) result.push_back(site);
+	}
+
+	std::sort(result.begin(), result.end(), [](const AllocationSite& a, const AllocationSite& b) { return a.Bytes > b.Bytes; });
+
+	return result;
+}
+
+void MemoryStatistics::LogLiveAllocationSites(uint64 maxSites)
+{
+	auto sites = GetLiveAllocationSites();
+
+	GARBAGE_CORE_INFO("Live tagged allocations: {} call site(s)", sites.size());
+
+	for (uint64 i = 0; i < sites.size() && i < maxSites; i++)
+	{
+		GARBAGE_CORE_INFO("  {}:{} - {} in {} allocation(s)", sites[i].File, sites[i].Line,
+			Utils::ConvertBytesQuantityToHumanReadableFormat(sites[i].Bytes), sites[i].NumberOfAllocations);
+	}
+}
\ No newline at end of file
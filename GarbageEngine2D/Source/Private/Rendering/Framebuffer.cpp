@@ -1,6 +1,28 @@
 #include "Rendering/Framebuffer.h"
 #include "Core/Assert.h"
+#include "Memory/Statistics.h"
+#include "Rendering/GpuTimer.h"
+#include "Rendering/Renderer.h"
 #include "OpenGL.h"
+#include <algorithm>
+
+// GPU time is measured from Bind until the framebuffer is unbound or another one is bound
+static uint32 s_passScope = GpuTimer::InvalidScope;
+
+// Drivers usually pad three-channel formats to four bytes
+static uint64 GetBytesPerPixel(Texture::Format format)
+{
+	switch (format)
+	{
+		case Texture::Format::Depth16: return 2;
+		case Texture::Format::RGB8:
+		case Texture::Format::RGBA8:
+		case Texture::Format::RedInteger:
+		case Texture::Format::Depth24Stencil8:
+		case Texture::Format::Depth32: return 4;
+		default: return 0;
+	}
+}
 
 FORCEINLINE static uint32 GetTextureTarget(bool multisampled)
 {
@@ -137,10 +159,18 @@ Framebuffer::~Framebuffer()
 	glDeleteFramebuffers(1, &m_id);
 	glDeleteTextures((GLsizei)m_colorAttachments.size(), m_colorAttachments.data());
 	glDeleteTextures(1, &m_depthAttachment);
+
+	MemoryStatistics::Resized(MemoryDomain::GPU, MemoryCategory::Framebuffers, m_sizeInVRam, 0);
 }
 
 void Framebuffer::Invalidate()
 {
+	// Recreating the attachments leaves the default framebuffer bound
+	Renderer::Flush();
+
+	GpuTimer::EndScope(s_passScope);
+	s_passScope = GpuTimer::InvalidScope;
+
 	if (m_id > 0)
 	{
 		glDeleteFramebuffers(1, &m_id);
@@ -230,16 +260,35 @@ void Framebuffer::Invalidate()
 	GARBAGE_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	const uint64 pixels = (uint64)m_specification.Width * (uint64)m_specification.Height * std::max<uint64>(m_specification.Samples, 1);
+
+	uint64 size = pixels * GetBytesPerPixel(m_depthAttachmentSpecification.Format);
+	for (auto& attachmentSpecification : m_colorAttachmentSpecifications) size += pixels * GetBytesPerPixel(attachmentSpecification.Format);
+
+	MemoryStatistics::Resized(MemoryDomain::GPU, MemoryCategory::Framebuffers, m_sizeInVRam, size);
+	m_sizeInVRam = size;
 }
 
 void Framebuffer::Bind()
 {
+	// Recorded quads belong to the previously bound target
+	Renderer::Flush();
+
+	GpuTimer::EndScope(s_passScope);
+	s_passScope = GpuTimer::BeginScope("Framebuffer pass");
+
 	glBindFramebuffer(GL_FRAMEBUFFER, m_id);
 	glViewport(0, 0, m_specification.Width, m_specification.Height);
 }
 
 void Framebuffer::Unbind()
 {
+	Renderer::Flush();
+
+	GpuTimer::EndScope(s_passScope);
+	s_passScope = GpuTimer::InvalidScope;
+
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -0,0 +1,201 @@
+#include "Rendering/GpuTimer.h"
+#include "Core/Log.h"
+#include "OpenGL.h"
+#include <algorithm>
+#include <iterator>
+
+struct GpuTimerFrame
+{
+	// Two timestamps per scope, the last two are the start and end of the whole frame
+	uint32 Queries[2 * GpuTimer::MaxScopesPerFrame + 2]{ 0 };
+	const char* Names[GpuTimer::MaxScopesPerFrame]{ nullptr };
+	bool Ended[GpuTimer::MaxScopesPerFrame]{ false };
+	uint32 NumberOfScopes{ 0 };
+	bool Pending{ false };
+};
+
+struct GpuTimerData
+{
+	GpuTimerFrame Frames[GpuTimer::FramesInFlight];
+	uint64 FrameIndex{ 0 };
+	bool FrameStarted{ false };
+
+	bool Supported{ false };
+	bool Enabled{ true };
+
+	std::vector<GpuTimer::PassTime> PassTimes;
+	float FrameMilliseconds{ 0.0f };
+	uint64 DroppedFrames{ 0 };
+};
+
+static constexpr uint32 FrameStartQuery = 2 * GpuTimer::MaxScopesPerFrame;
+static constexpr uint32 FrameEndQuery = FrameStartQuery + 1;
+
+static GpuTimerData s_data;
+
+static float QueriesToMilliseconds(uint32 beginQuery, uint32 endQuery)
+{
+	GLuint64 begin = 0, end = 0;
+	glGetQueryObjectui64v(beginQuery, GL_QUERY_RESULT, &begin);
+	glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &end);
+
+	return end > begin ? (float)(end - begin) / 1000000.0f : 0.0f;
+}
+
+static void ReadResults(GpuTimerFrame& frame)
+{
+	s_data.PassTimes.clear();
+
+	for (uint32 i = 0; i < frame.NumberOfScopes; i++)
+	{
+		if (!frame.Ended[i]) continue;
+
+		const float milliseconds = QueriesToMilliseconds(frame.Queries[2 * i], frame.Queries[2 * i + 1]);
+		const std::string_view name = frame.Names[i];
+
+		auto it = std::find_if(s_data.PassTimes.begin(), s_data.PassTimes.end(), [name](const auto& pass) { return pass.Name == name; });
+		if (it == s_data.PassTimes.end()) it = s_data.PassTimes.insert(it, { name, 0.0f, 0 });
+
+		it->Milliseconds += milliseconds;
+		it->Count++;
+	}
+
+	s_data.FrameMilliseconds = QueriesToMilliseconds(frame.Queries[FrameStartQuery], frame.Queries[FrameEndQuery]);
+}
+
+void GpuTimer::Init()
+{
+	s_data.Supported = GLAD_GL_VERSION_3_3 != 0;
+
+	if (!s_data.Supported)
+	{
+		GARBAGE_CORE_WARN("Timer queries are not supported, GPU timings are disabled");
+		return;
+	}
+
+	for (auto& frame : s_data.Frames)
+	{
+		glGenQueries((GLsizei)std::size(frame.Queries), frame.Queries);
+	}
+}
+
+void GpuTimer::Shutdown()
+{
+	if (!s_data.Supported) return;
+
+	for (auto& frame : s_data.Frames)
+	{
+		glDeleteQueries((GLsizei)std::size(frame.Queries), frame.Queries);
+		frame = GpuTimerFrame();
+	}
+
+	s_data.FrameStarted = false;
+	s_data.Supported = false;
+}
+
+bool GpuTimer::IsSupported()
+{
+	return s_data.Supported;
+}
+
+void GpuTimer::SetEnabled(bool enabled)
+{
+	s_data.Enabled = enabled;
+}
+
+bool GpuTimer::IsEnabled()
+{
+	return s_data.Supported && s_data.Enabled;
+}
+
+void GpuTimer::BeginFrame()
+{
+	if (!s_data.Supported) return;
+
+	// The previous frame was never ended
+	if (s_data.FrameStarted) EndFrame();
+
+	s_data.FrameStarted = IsEnabled();
+
+	// The oldest frame is reused now, its results are read first if the GPU has finished it
+	GpuTimerFrame& frame = s_data.Frames[s_data.FrameIndex % FramesInFlight];
+
+	if (frame.Pending)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(frame.Queries[FrameEndQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (available) ReadResults(frame);
+		else s_data.DroppedFrames++;
+
+		frame.Pending = false;
+	}
+
+	frame.NumberOfScopes = 0;
+
+	if (s_data.FrameStarted) glQueryCounter(frame.Queries[FrameStartQuery], GL_TIMESTAMP);
+}
+
+void GpuTimer::EndFrame()
+{
+	if (!s_data.FrameStarted) return;
+
+	GpuTimerFrame& frame = s_data.Frames[s_data.FrameIndex % FramesInFlight];
+
+	for (uint32 i = 0; i < frame.NumberOfScopes; i++)
+	{
+		if (frame.Ended[i]) continue;
+
+		frame.Ended[i] = true;
+		glQueryCounter(frame.Queries[2 * i + 1], GL_TIMESTAMP);
+	}
+
+	glQueryCounter(frame.Queries[FrameEndQuery], GL_TIMESTAMP);
+	frame.Pending = true;
+
+	s_data.FrameIndex++;
+	s_data.FrameStarted = false;
+}
+
+uint32 GpuTimer::BeginScope(const char* name)
+{
+	if (!s_data.FrameStarted) return InvalidScope;
+
+	GpuTimerFrame& frame = s_data.Frames[s_data.FrameIndex % FramesInFlight];
+	if (frame.NumberOfScopes == MaxScopesPerFrame) return InvalidScope;
+
+	const uint32 scope = frame.NumberOfScopes++;
+
+	frame.Names[scope] = name;
+	frame.Ended[scope] = false;
+	glQueryCounter(frame.Queries[2 * scope], GL_TIMESTAMP);
+
+	// Upper bits identify the frame, so scopes left open across BeginFrame are ignored
+	return (uint32)(s_data.FrameIndex & 0xFFFF) << 16 | scope;
+}
+
+void GpuTimer::EndScope(uint32 scope)
+{
+	if (scope == InvalidScope || !s_data.FrameStarted || scope >> 16 != (uint32)(s_data.FrameIndex & 0xFFFF)) return;
+
+	GpuTimerFrame& frame = s_data.Frames[s_data.FrameIndex % FramesInFlight];
+	const uint32 index = scope & 0xFFFF;
+
+	frame.Ended[index] = true;
+	glQueryCounter(frame.Queries[2 * index + 1], GL_TIMESTAMP);
+}
+
+const std::vector<GpuTimer::PassTime>& GpuTimer::GetPassTimes()
+{
+	return s_data.PassTimes;
+}
+
+float GpuTimer::GetFrameMilliseconds()
+{
+	return s_data.FrameMilliseconds;
+}
+
+uint64 GpuTimer::GetNumberOfDroppedFrames()
+{
+	return s_data.DroppedFrames;
+}
\ No newline at end of file
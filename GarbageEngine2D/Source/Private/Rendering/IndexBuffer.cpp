@@ -1,5 +1,6 @@
 #include "Rendering/IndexBuffer.h"
 #include "Core/Assert.h"
+#include "Memory/Statistics.h"
 #include <glad/glad.h>
 
 IndexBuffer::IndexBuffer(const uint32* data, uint32 count) : m_count(count)
@@ -9,11 +10,15 @@ IndexBuffer::IndexBuffer(const uint32* data, uint32 count) : m_count(count)
 	glGenBuffers(1, &m_id);
 	Bind();
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32), data, GL_STATIC_DRAW);
+
+	MemoryStatistics::Allocated(MemoryDomain::GPU, MemoryCategory::IndexBuffers, (uint64)count * sizeof(uint32));
 }
 
 IndexBuffer::~IndexBuffer()
 {
 	glDeleteBuffers(1, &m_id);
+
+	MemoryStatistics::Freed(MemoryDomain::GPU, MemoryCategory::IndexBuffers, (uint64)m_count * sizeof(uint32));
 }
 
 void IndexBuffer::Bind() const
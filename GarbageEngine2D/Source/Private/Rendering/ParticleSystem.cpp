@@ -1,65 +1,201 @@
 #include "Rendering/ParticleSystem.h"
 #include "Core/Application.h"
+#include "Math/Matrix4.h"
 #include "Math/Random.h"
+#include "Math/SIMD.h"
 #include <glad/glad.h>
+#include <algorithm>
+#include <atomic>
 
-static Random s_random;
+static std::atomic<uint32> s_nextSeed{ 1 };
+
+void ParticleSystem::ParticleStreams::Resize(uint64 capacity)
+{
+	PositionX.resize(capacity);
+	PositionY.resize(capacity);
+	PositionZ.resize(capacity);
+	VelocityX.resize(capacity);
+	VelocityY.resize(capacity);
+	VelocityZ.resize(capacity);
+	LifeTime.resize(capacity);
+	StartLifeTime.resize(capacity);
+	Size.resize(capacity);
+	Colors.resize(capacity);
+
+	Count = capacity;
+}
+
+void ParticleSystem::ParticleStreams::Move(uint64 from, uint64 to)
+{
+	PositionX[to] = PositionX[from];
+	PositionY[to] = PositionY[from];
+	PositionZ[to] = PositionZ[from];
+	VelocityX[to] = VelocityX[from];
+	VelocityY[to] = VelocityY[from];
+	VelocityZ[to] = VelocityZ[from];
+	LifeTime[to] = LifeTime[from];
+	StartLifeTime[to] = StartLifeTime[from];
+	Size[to] = Size[from];
+	Colors[to] = Colors[from];
+}
 
 ParticleSystem::ParticleSystem(const Specification& specification, Vector3 worldPosition) : m_specification(specification), WorldPosition(worldPosition)
 {
-	m_particles.reserve(specification.StartCapacity);
+	m_seed = specification.Seed != 0 ? specification.Seed : s_nextSeed.fetch_add(1);
+
+	BakeCurves();
+
+	m_particles.Resize(specification.StartCapacity);
 
 	Vector3 additivePosition = m_specification.SimulationSpace == SimulationSpace::World ? WorldPosition : Vector3(0.0f);
 
-	for (uint32 i = 0; i < specification.StartCapacity; i++)
+	for (uint64 chunkIndex = 0; chunkIndex < GetNumberOfChunks(); chunkIndex++)
 	{
-		float startLifeTime = s_random.NextFloat(specification.LifeTimeMin, specification.LifeTimeMax);
-
-		m_particles.push_back(
-			{
-				s_random.NextVector3(specification.StartVelocityMin, specification.StartVelocityMax),
-				s_random.NextVector3(additivePosition + specification.StartPositionMin, additivePosition + specification.StartPositionMax),
-				m_specification.ColorOverLifeTime.Evaluate(0.0f),
-				startLifeTime,
-				startLifeTime,
-				m_specification.SizeOverLifeTime.Evaluate(0.0f),
-				true
-			});
+		Random random = GetChunkRandom(chunkIndex);
+
+		const uint64 begin = chunkIndex * ChunkSize;
+		const uint64 end = std::min(begin + ChunkSize, m_particles.Count);
+
+		for (uint64 i = begin; i < end; i++) SpawnParticle(i, random, additivePosition);
 	}
+
+	m_tickIndex++;
 }
 
 void ParticleSystem::Tick(float deltaTime)
+{
+	BakeCurves();
+
+	for (uint64 chunkIndex = 0; chunkIndex < GetNumberOfChunks(); chunkIndex++)
+	{
+		TickChunk(chunkIndex, deltaTime);
+	}
+
+	m_tickIndex++;
+}
+
+void ParticleSystem::TickChunk(uint64 chunkIndex, float deltaTime)
 {
 	Vector3 additivePosition = m_specification.SimulationSpace == SimulationSpace::World ? WorldPosition : Vector3(0.0f);
 
-	for (auto& particle : m_particles)
+	const uint64 begin = chunkIndex * ChunkSize;
+	const uint64 end = std::min(begin + ChunkSize, m_particles.Count);
+
+	IntegrateParticles(begin, end, deltaTime);
+
+	// Expired particles are swap-removed inside of the chunk, alive ones end up packed at its front
+	uint64 aliveEnd = end;
+	for (uint64 i = begin; i < aliveEnd;)
 	{
-		if (!particle.IsAlive) continue;
-
-		particle.LifeTime -= deltaTime;
-
-		if (particle.LifeTime <= 0)
-		{
-			float startLifeTime = s_random.NextFloat(m_specification.LifeTimeMin, m_specification.LifeTimeMax);
-			particle = {
-				s_random.NextVector3(m_specification.StartVelocityMin, m_specification.StartVelocityMax),
-				s_random.NextVector3(additivePosition + m_specification.StartPositionMin, additivePosition + m_specification.StartPositionMax),
-				m_specification.ColorOverLifeTime.Evaluate(0.0f),
-				startLifeTime,
-				startLifeTime,
-				m_specification.SizeOverLifeTime.Evaluate(0.0f),
-				true
-			};
-			continue;
-		}
-
-		float particleLifeTimeProgress = (particle.StartLifeTime - particle.LifeTime) / particle.StartLifeTime;
-
-		particle.Velocity += Vector3(0, -9.81f, 0) * m_specification.GravityMultiplier * deltaTime;
-		particle.Velocity *= 1.0f - m_specification.Drag;
-		particle.Position += particle.Velocity * deltaTime;
-		particle.Size = m_specification.SizeOverLifeTime.Evaluate(particleLifeTimeProgress);
-		particle.Color = m_specification.ColorOverLifeTime.Evaluate(particleLifeTimeProgress);
+		if (m_particles.LifeTime[i] <= 0.0f) m_particles.Move(--aliveEnd, i);
+		else i++;
+	}
+
+	EvaluateParticleCurves(begin, aliveEnd);
+
+	// Emission is continuous, every dead particle is replaced with a new one
+	if (aliveEnd == end) return;
+
+	Random random = GetChunkRandom(chunkIndex);
+	for (uint64 i = aliveEnd; i < end; i++) SpawnParticle(i, random, additivePosition);
+}
+
+Random ParticleSystem::GetChunkRandom(uint64 chunkIndex) const
+{
+	// SplitMix64 finalizer, neighbouring chunks and ticks get unrelated streams
+	uint64 hash = (uint64)m_seed * 0x9E3779B97F4A7C15ull ^ m_tickIndex * 0xBF58476D1CE4E5B9ull ^ chunkIndex * 0x94D049BB133111EBull;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+	hash ^= hash >> 31;
+
+	return Random((uint32)(hash ^ (hash >> 32)));
+}
+
+void ParticleSystem::SpawnParticle(uint64 index, const Random& random, const Vector3& additivePosition)
+{
+	const float startLifeTime = random.NextFloat(m_specification.LifeTimeMin, m_specification.LifeTimeMax);
+	const Vector3 velocity = random.NextVector3(m_specification.StartVelocityMin, m_specification.StartVelocityMax);
+	const Vector3 position = random.NextVector3(additivePosition + m_specification.StartPositionMin, additivePosition + m_specification.StartPositionMax);
+
+	m_particles.PositionX[index] = position.X;
+	m_particles.PositionY[index] = position.Y;
+	m_particles.PositionZ[index] = position.Z;
+	m_particles.VelocityX[index] = velocity.X;
+	m_particles.VelocityY[index] = velocity.Y;
+	m_particles.VelocityZ[index] = velocity.Z;
+	m_particles.LifeTime[index] = startLifeTime;
+	m_particles.StartLifeTime[index] = startLifeTime;
+	m_particles.Size[index] = m_specification.SizeOverLifeTime.Evaluate(0.0f);
+	m_particles.Colors[index] = m_specification.ColorOverLifeTime.EvaluatePacked(0.0f);
+}
+
+void ParticleSystem::IntegrateParticles(uint64 begin, uint64 end, float deltaTime)
+{
+	const float gravity = -9.81f * m_specification.GravityMultiplier * deltaTime;
+	const float damping = 1.0f - m_specification.Drag;
+
+	float* positionX = m_particles.PositionX.data();
+	float* positionY = m_particles.PositionY.data();
+	float* positionZ = m_particles.PositionZ.data();
+	float* velocityX = m_particles.VelocityX.data();
+	float* velocityY = m_particles.VelocityY.data();
+	float* velocityZ = m_particles.VelocityZ.data();
+	float* lifeTime = m_particles.LifeTime.data();
+
+	uint64 i = begin;
+
+#if GARBAGE_SIMD_SSE2
+	const __m128 deltaTime4 = _mm_set1_ps(deltaTime);
+	const __m128 gravity4 = _mm_set1_ps(gravity);
+	const __m128 damping4 = _mm_set1_ps(damping);
+
+	for (; i + 4 <= end; i += 4)
+	{
+		_mm_storeu_ps(lifeTime + i, _mm_sub_ps(_mm_loadu_ps(lifeTime + i), deltaTime4));
+
+		const __m128 vx = _mm_mul_ps(_mm_loadu_ps(velocityX + i), damping4);
+		const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityY + i), gravity4), damping4);
+		const __m128 vz = _mm_mul_ps(_mm_loadu_ps(velocityZ + i), damping4);
+
+		_mm_storeu_ps(velocityX + i, vx);
+		_mm_storeu_ps(velocityY + i, vy);
+		_mm_storeu_ps(velocityZ + i, vz);
+
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, deltaTime4)));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, deltaTime4)));
+		_mm_storeu_ps(positionZ + i, _mm_add_ps(_mm_loadu_ps(positionZ + i), _mm_mul_ps(vz, deltaTime4)));
+	}
+#endif
+
+	for (; i < end; i++)
+	{
+		lifeTime[i] -= deltaTime;
+
+		velocityX[i] *= damping;
+		velocityY[i] = (velocityY[i] + gravity) * damping;
+		velocityZ[i] *= damping;
+
+		positionX[i] += velocityX[i] * deltaTime;
+		positionY[i] += velocityY[i] * deltaTime;
+		positionZ[i] += velocityZ[i] * deltaTime;
+	}
+}
+
+void ParticleSystem::BakeCurves()
+{
+	// Curves are evaluated twice per particle every tick. A bake done with custom settings is kept, or redone with them
+	m_specification.SizeOverLifeTime.EnsureBaked();
+	m_specification.ColorOverLifeTime.EnsureBaked();
+}
+
+void ParticleSystem::EvaluateParticleCurves(uint64 begin, uint64 end)
+{
+	for (uint64 i = begin; i < end; i++)
+	{
+		const float progress = (m_particles.StartLifeTime[i] - m_particles.LifeTime[i]) / m_particles.StartLifeTime[i];
+
+		m_particles.Size[i] = m_specification.SizeOverLifeTime.Evaluate(progress);
+		m_particles.Colors[i] = m_specification.ColorOverLifeTime.EvaluatePacked(progress);
 	}
 }
 
@@ -104,42 +240,57 @@ ParticleSystemProxy::ParticleSystemProxy(const ParticleSystem& particleSystem) :
 
 	m_vertexArray->AddBuffer(*m_dataBuffer, dataLayout);
 
-	m_positionsSizes.reserve(m_particleSystem.m_specification.StartCapacity);
-	m_colors.reserve(m_particleSystem.m_specification.StartCapacity);
+	for (auto& snapshot : m_snapshots)
+	{
+		snapshot.PositionsSizes.reserve(m_particleSystem.m_specification.StartCapacity);
+		snapshot.Colors.reserve(m_particleSystem.m_specification.StartCapacity);
+	}
 
-	m_positionsSizes.push_back({ 0.0f, 0.0f, 0.0f, 0.0f });
-	m_colors.push_back({ 0.0f, 0.0f, 0.0f, 1.0f });
+	Vector4 positionSize(0.0f, 0.0f, 0.0f, 0.0f);
+	uint32 color = Color(0.0f, 0.0f, 0.0f, 1.0f).GetAsPackedRGBA8();
 
-	m_positionsBuffer.reset(new VertexBuffer(m_positionsSizes.data(), (uint32)(m_positionsSizes.size() * sizeof(Vector4)), (uint32)m_positionsSizes.size(), true));
-	m_colorsBuffer.reset(new VertexBuffer(m_colors.data(), (uint32)(m_colors.size() * sizeof(Vector4)), (uint32)m_colors.size(), true));
+	m_positionsBuffer.reset(new VertexBuffer(&positionSize, (uint32)sizeof(Vector4), 1, true));
+	m_colorsBuffer.reset(new VertexBuffer(&color, (uint32)sizeof(uint32), 1, true));
 
 	VertexBufferLayout positionsDataLayout;
 	positionsDataLayout.Push<Vector4>(1);
 	m_vertexArray->AddBuffer(*m_positionsBuffer, positionsDataLayout);
 
 	VertexBufferLayout colorsDataLayout;
-	colorsDataLayout.Push<Vector4>(1);
+	colorsDataLayout.Push<uint8>(4);
 	m_vertexArray->AddBuffer(*m_colorsBuffer, colorsDataLayout);
 }
 
 void ParticleSystemProxy::CopyData(const ParticleSystem& particleSystem)
 {
-	std::scoped_lock<std::mutex> lockGuard(m_copyDataMutex);
+	const auto& particles = particleSystem.m_particles;
+	Snapshot& snapshot = m_snapshots[m_writeSnapshot];
 
-	m_positionsSizes.clear();
-	m_colors.clear();
+	snapshot.PositionsSizes.resize(particles.Count);
+	snapshot.Colors.assign(particles.Colors.begin(), particles.Colors.begin() + particles.Count);
 
-	for (auto& particle : particleSystem.m_particles)
-	{
-		if (!particle.IsAlive) continue;
+	m_planarPositions.resize(particles.Count);
+	for (uint64 i = 0; i < particles.Count; i++) m_planarPositions[i] = Vector2(particles.PositionX[i], particles.PositionY[i]);
+
+	// Snapshots are in world space, local particles are moved by the position of the system
+	const Vector3 offset = particleSystem.m_specification.SimulationSpace == ParticleSystem::SimulationSpace::Local ? particleSystem.WorldPosition : Vector3(0.0f);
+
+	Matrix4 transform = Matrix4::Identity;
+	transform.M[3] = Vector4(offset, 0.0f);
 
-		m_positionsSizes.push_back({ particle.Position, particle.Size });
-		m_colors.push_back(particle.Color);
+	TransformPoints(transform, m_planarPositions.data(), snapshot.PositionsSizes.data(), particles.Count);
+
+	for (uint64 i = 0; i < particles.Count; i++)
+	{
+		snapshot.PositionsSizes[i].Z += particles.PositionZ[i];
+		snapshot.PositionsSizes[i].W = particles.Size[i];
 	}
 
-	m_worldPosition = particleSystem.m_specification.SimulationSpace == ParticleSystem::SimulationSpace::Local ? particleSystem.WorldPosition : Vector3(0.0f);
+	// Release makes the snapshot contents visible to the render thread once it acquires the index
+	const uint32 previous = m_publishedSnapshot.exchange(m_writeSnapshot | FreshSnapshotBit, std::memory_order_acq_rel);
+	if (previous & FreshSnapshotBit) m_droppedSnapshots.fetch_add(1, std::memory_order_relaxed);
 
-	m_dataWasUpdated = true;
+	m_writeSnapshot = previous & SnapshotIndexMask;
 }
 
 void ParticleSystemProxy::CopyData()
@@ -149,21 +300,27 @@ void ParticleSystemProxy::CopyData()
 
 void ParticleSystemProxy::Draw(const Shader& shader)
 {
-	std::scoped_lock<std::mutex> lockGuard(m_copyDataMutex);
-
-	if (m_dataWasUpdated)
+	if (m_publishedSnapshot.load(std::memory_order_relaxed) & FreshSnapshotBit)
 	{
+		const uint32 previous = m_publishedSnapshot.exchange(m_readSnapshot, std::memory_order_acq_rel);
+		m_readSnapshot = previous & SnapshotIndexMask;
+
+		const Snapshot& snapshot = m_snapshots[m_readSnapshot];
+
 		m_positionsBuffer->Bind();
-		m_positionsBuffer->UpdateData(m_positionsSizes.data(), (uint32)(m_positionsSizes.size() * sizeof(Vector4)));
+		m_positionsBuffer->UpdateData(snapshot.PositionsSizes.data(), (uint32)(snapshot.PositionsSizes.size() * sizeof(Vector4)));
 		m_colorsBuffer->Bind();
-		m_colorsBuffer->UpdateData(m_colors.data(), (uint32)(m_colors.size() * sizeof(Vector4)));
-
-		m_dataWasUpdated = false;
+		m_colorsBuffer->UpdateData(snapshot.Colors.data(), (uint32)(snapshot.Colors.size() * sizeof(uint32)));
+	}
+	else
+	{
+		m_reusedSnapshots.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	m_vertexArray->Bind();
 
-	shader.SetVector3("u_worldPosition", m_worldPosition);
+	// Offset of local particles is already applied in CopyData
+	shader.SetVector3("u_worldPosition", Vector3(0.0f));
 
 	/*auto& renderer = Application::Get().GetRenderer();
 	renderer.EnableFeature(Renderer::Feature::AlphaBlending);
@@ -0,0 +1,58 @@
+#include "Rendering/ParticleWorld.h"
+#include "Core/JobSystem.h"
+#include "Core/Profiling.h"
+#include <algorithm>
+
+ParticleSystem* ParticleWorld::AddSystem(const ParticleSystem::Specification& specification, Vector3 worldPosition)
+{
+	m_systems.emplace_back(new ParticleSystem(specification, worldPosition));
+	return m_systems.back().get();
+}
+
+void ParticleWorld::RemoveSystem(ParticleSystem* particleSystem)
+{
+	auto it = std::find_if(m_systems.begin(), m_systems.end(), [particleSystem](const auto& system) { return system.get() == particleSystem; });
+	if (it != m_systems.end()) m_systems.erase(it);
+}
+
+void ParticleWorld::Tick(float deltaTime)
+{
+	GARBAGE_CORE_PROFILE_FUNCTION();
+
+	m_chunkItems.clear();
+
+	uint64 numberOfParticles = 0;
+
+	for (auto& system : m_systems)
+	{
+		numberOfParticles += system->m_particles.Count;
+		system->BakeCurves();
+
+		for (uint64 chunkIndex = 0; chunkIndex < system->GetNumberOfChunks(); chunkIndex++)
+		{
+			m_chunkItems.push_back({ system.get(), chunkIndex });
+		}
+	}
+
+	JobSystem::ParallelFor(m_chunkItems.size(), 1, [this, deltaTime](uint64 index)
+		{
+			m_chunkItems[index].System->TickChunk(m_chunkItems[index].ChunkIndex, deltaTime);
+		});
+
+	for (auto& system : m_systems)
+	{
+		system->m_tickIndex++;
+	}
+
+	GARBAGE_PROFILE_COUNTER("Particles", numberOfParticles);
+}
+
+void ParticleWorld::CopyData()
+{
+	GARBAGE_CORE_PROFILE_FUNCTION();
+
+	JobSystem::ParallelFor(m_systems.size(), 1, [this](uint64 index)
+		{
+			if (auto proxy = m_systems[index]->GetProxy()) proxy->CopyData(*m_systems[index]);
+		});
+}
\ No newline at end of file
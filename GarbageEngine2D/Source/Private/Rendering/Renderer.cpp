@@ -1,18 +1,30 @@
 #include "Rendering/Renderer.h"
 #include "Core/Assert.h"
 #include "Core/Profiling.h"
+#include "Rendering/GpuTimer.h"
 #include "Rendering/Shader.h"
 #include "Rendering/Texture.h"
+#include "Rendering/TextureAtlas.h"
+#include "Math/Half.h"
+#include "Math/Math.h"
+#include "Memory/Statistics.h"
 #include "OpenGL.h"
 #pragma warning(push, 0)
 #include <GLFW/glfw3.h>
 #pragma warning(pop)
+#include <algorithm>
 #include <thread>
 #include <sstream>
+#include <vector>
+#include <cstring>
 
 static Renderer::Statistics s_statistics;
 static Timer s_rendererTimer;
 
+static Renderer::Statistics s_frameHistory[Renderer::FrameHistorySize];
+static uint32 s_frameHistoryHead = 0;
+static uint32 s_numberOfRecordedFrames = 0;
+
 struct QuadVertex
 {
 	// Using Vector4 instead of Vector2 for Position is because of aligning issues :(
@@ -23,6 +35,49 @@ struct QuadVertex
 	float Tiling{ 1.0f };
 };
 
+// Only the 2D affine part of the transform is kept, quad vertices are always transformed
+// as (x, y, 1, 1) and only X and Y of the result reach the shader
+struct QuadCommand
+{
+	Color Color;
+	Vector2 AxisX;
+	Vector2 AxisY;
+	Vector2 Origin;
+	const Texture2D* Texture{ nullptr };
+	float Tiling{ 1.0f };
+	Vector2 UVMin{ 0.0f, 0.0f };
+	Vector2 UVMax{ 1.0f, 1.0f };
+};
+
+// Compact per-sprite record for the instanced path, the vertex shader expands it into a quad.
+// Origin and axes are full floats, so corners land exactly where the Vertices path puts them
+struct QuadInstance
+{
+	Vector2 Origin;
+	// X axis, then Y axis
+	float Axes[4];
+	// Normalized: min X, min Y, max X, max Y
+	uint16 UVRect[4];
+	uint32 Color;
+	Half TextureIndexAndTiling[2];
+};
+
+static_assert(sizeof(QuadInstance) == 40, "Quad instance must stay 40 bytes");
+
+// Sort key layout, from the most significant bits: layer (8), blend mode (2), texture id (22), depth (32).
+// Texture id stays zero while alpha blending is enabled, so blended quads keep depth and submission order
+struct QuadSortEntry
+{
+	uint64 Key;
+	uint32 Index;
+};
+
+static constexpr uint64 QuadSortKeyLayerShift = 56;
+static constexpr uint64 QuadSortKeyBlendModeShift = 54;
+static constexpr uint64 QuadSortKeyBlendModeMask = 0x3;
+static constexpr uint64 QuadSortKeyTextureShift = 32;
+static constexpr uint64 QuadSortKeyTextureMask = 0x3fffff;
+
 static constexpr uint64 QuadVertexCount = 4;
 static constexpr uint64 QuadIndexCount = 6;
 
@@ -31,6 +86,7 @@ static struct Renderer2DData
 	static const uint32_t MaxQuads = 20000;
 	static const uint32_t MaxVertices = MaxQuads * QuadVertexCount;
 	static const uint32_t MaxIndices = MaxQuads * QuadIndexCount;
+	static const uint8 VertexStreamRegions = 3;
 
 	Ref<VertexArray> QuadVertexArray;
 	Ref<VertexBuffer> QuadVertexBuffer;
@@ -38,14 +94,35 @@ static struct Renderer2DData
 	Ref<Shader> QuadShader;
 	Ref<Texture2D> WhiteTexture;
 
-	Scope<QuadVertex[]> QuadVertexBufferBase = nullptr;
+	// Points to the mapped region of QuadVertexBuffer
+	QuadVertex* QuadVertexBufferBase = nullptr;
 	QuadVertex* QuadVertexBufferPtr = nullptr;
 
+	// OpenGL 3.3 has no base instance, so every stream region gets its own vertex array with offset attributes
+	Ref<VertexArray> QuadInstanceVertexArrays[VertexStreamRegions];
+	Ref<VertexBuffer> QuadInstanceBuffer;
+	Ref<Shader> QuadInstanceShader;
+
+	// Points to the mapped region of QuadInstanceBuffer
+	QuadInstance* QuadInstanceBufferBase = nullptr;
+	QuadInstance* QuadInstanceBufferPtr = nullptr;
+
+	Renderer::QuadRenderingMode QuadRenderingMode = Renderer::QuadRenderingMode::Instanced;
+	bool AlphaBlending = false;
+
 	Scope<const Texture2D*[]> TextureSlots;
 	uint32 TextureSlotIndex = 1;
+	uint32 NumberOfTextureSlots = 0;
 
 	uint32 QuadIndexCount = 0;
 
+	std::vector<QuadCommand> QuadCommands;
+	std::vector<QuadSortEntry> QuadSortEntries;
+	std::vector<QuadSortEntry> QuadSortScratch;
+
+	uint8 Layer = 0;
+	Renderer::BlendMode BlendMode = Renderer::BlendMode::Default;
+
 	Vector2 QuadVertexPositions[QuadVertexCount];
 
 	Matrix4 Projection{ 0.0f };
@@ -84,6 +161,76 @@ static uint32 GarbageEngineRenderingDepthFunctionToOpenGL(Renderer::DepthFunctio
 	return 0;
 }
 
+static void SetOpenGLBlendFunction(Renderer::BlendMode blendMode)
+{
+	switch (blendMode)
+	{
+		case Renderer::BlendMode::Default: glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); break;
+		case Renderer::BlendMode::Additive:glBlendFunc(GL_SRC_ALPHA, GL_ONE); break;
+	}
+}
+
+FORCEINLINE static uint16 PackUnorm16(float value)
+{
+	return (uint16)(Math::Clamp01(value) * 65535.0f + 0.5f);
+}
+
+static void BindTextureSamplers(const Shader& shader, int32 numberOfTextureUnits)
+{
+	shader.Bind();
+
+	for (int32 i = 0; i < numberOfTextureUnits; i++)
+	{
+		std::stringstream ss;
+		ss << "u_textures[" << i << "]";
+		std::string uniform = ss.str();
+
+		shader.SetInt32(uniform, i);
+	}
+}
+
+// Maps float to uint32 so that unsigned comparison gives the same order as float comparison
+FORCEINLINE static uint32 FloatToSortableBits(float value)
+{
+	uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+// Stable LSD radix sort by 8 bits per pass, passes where all keys share the same digit are skipped
+static void RadixSort(std::vector<QuadSortEntry>& entries, std::vector<QuadSortEntry>& scratch)
+{
+	const uint64 count = entries.size();
+	scratch.resize(count);
+
+	QuadSortEntry* source = entries.data();
+	QuadSortEntry* destination = scratch.data();
+
+	for (uint64 shift = 0; shift < 64; shift += 8)
+	{
+		uint64 histogram[256] = { 0 };
+
+		for (uint64 i = 0; i < count; i++) histogram[(source[i].Key >> shift) & 0xff]++;
+
+		if (histogram[(source[0].Key >> shift) & 0xff] == count) continue;
+
+		uint64 offset = 0;
+		for (uint32 i = 0; i < 256; i++)
+		{
+			const uint64 digitCount = histogram[i];
+			histogram[i] = offset;
+			offset += digitCount;
+		}
+
+		for (uint64 i = 0; i < count; i++) destination[histogram[(source[i].Key >> shift) & 0xff]++] = source[i];
+
+		std::swap(source, destination);
+	}
+
+	if (source != entries.data()) std::memcpy(entries.data(), source, count * sizeof(QuadSortEntry));
+}
+
 void Renderer::Init()
 {
 	GARBAGE_CORE_PROFILE_FUNCTION();
@@ -99,11 +246,13 @@ void Renderer::Init()
 	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_maxTextureSize);
 	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &m_numberOfTextureUnits);
 
+	GpuTimer::Init();
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
 	s_data.QuadVertexArray = MakeRef<VertexArray>();
 
-	s_data.QuadVertexBuffer = MakeRef<VertexBuffer>(nullptr, s_data.MaxVertices * sizeof(QuadVertex), s_data.MaxVertices, true);
+	s_data.QuadVertexBuffer = MakeRef<VertexBuffer>(s_data.MaxVertices * (uint32)sizeof(QuadVertex), s_data.MaxVertices, s_data.VertexStreamRegions);
 
 	VertexBufferLayout layout;
 	layout.Push<Vector4>(1);
@@ -116,8 +265,6 @@ void Renderer::Init()
 
 	s_data.QuadVertexArray->AddBuffer(*s_data.QuadVertexBuffer, layout);
 
-	s_data.QuadVertexBufferBase = MakeScope<QuadVertex[]>(s_data.MaxVertices);
-
 	uint32* quadIndices = new uint32[s_data.MaxIndices];
 
 	uint32 offset = 0;
@@ -137,6 +284,23 @@ void Renderer::Init()
 	s_data.QuadIndexBuffer = MakeRef<IndexBuffer>(quadIndices, s_data.MaxIndices);
 	delete[] quadIndices;
 
+	s_data.QuadInstanceBuffer = MakeRef<VertexBuffer>(s_data.MaxQuads * (uint32)sizeof(QuadInstance), s_data.MaxQuads, s_data.VertexStreamRegions, true);
+
+	VertexBufferLayout instanceLayout;
+	instanceLayout.Push<Vector2>(1);
+	instanceLayout.Push<float>(4);
+	instanceLayout.Push<uint16>(4);
+	instanceLayout.Push<uint8>(4);
+	instanceLayout.Push<Half>(2);
+
+	GARBAGE_CORE_ASSERT(instanceLayout.GetStride() == sizeof(QuadInstance));
+
+	for (uint8 i = 0; i < s_data.VertexStreamRegions; i++)
+	{
+		s_data.QuadInstanceVertexArrays[i] = MakeRef<VertexArray>();
+		s_data.QuadInstanceVertexArrays[i]->AddBuffer(*s_data.QuadInstanceBuffer, instanceLayout, (uint64)i * s_data.QuadInstanceBuffer->GetStreamRegionSize());
+	}
+
 	Texture::Specification whiteTextureSpecification;
 
 	whiteTextureSpecification.Width = whiteTextureSpecification.Height = 1;
@@ -209,17 +373,39 @@ void Renderer::Init()
 	sources[Shader::Type::Fragment] = source;
 
 	s_data.QuadShader = MakeRef<Shader>(sources);
+	BindTextureSamplers(*s_data.QuadShader, m_numberOfTextureUnits);
 
-	s_data.QuadShader->Bind();
-
-	for (uint32 i = 0; i < m_numberOfTextureUnits; i++)
-	{
-		std::stringstream ss;
-		ss << "u_textures[" << i << "]";
-		std::string uniform = ss.str();
+	sources[Shader::Type::Vertex] = R"(
+		layout (location = 0) in vec2 a_Origin;
+		layout (location = 1) in vec4 a_Axes;
+		layout (location = 2) in vec4 a_UVRect;
+		layout (location = 3) in vec4 a_Color;
+		layout (location = 4) in vec2 a_TexIndexAndTiling;
+		
+		out vec4 Color;
+		out vec2 TexCoord;
+		out float TexIndex;
+		out float Tiling;
+		
+		uniform mat4 u_viewProjection;
+		
+		const vec2 c_corners[6] = vec2[6](vec2(-0.5, 0.5), vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(-0.5, 0.5), vec2(0.5, -0.5), vec2(0.5, 0.5));
+		
+		void main()
+		{
+			vec2 corner = c_corners[gl_VertexID];
+			vec2 position = a_Origin + a_Axes.xy * corner.x + a_Axes.zw * corner.y;
+			
+			gl_Position = u_viewProjection * vec4(position, 0.0, 1.0);
+			Color = a_Color;
+			TexCoord = mix(a_UVRect.xy, a_UVRect.zw, corner + 0.5);
+			TexIndex = a_TexIndexAndTiling.x;
+			Tiling = a_TexIndexAndTiling.y;
+		}
+)";
 
-		s_data.QuadShader->SetInt32(uniform, i);
-	}
+	s_data.QuadInstanceShader = MakeRef<Shader>(sources);
+	BindTextureSamplers(*s_data.QuadInstanceShader, m_numberOfTextureUnits);
 	
 	s_data.QuadVertexPositions[0] = Vector2(-0.5f, 0.5f);
 	s_data.QuadVertexPositions[1] = Vector2(-0.5f, -0.5f);
@@ -227,8 +413,13 @@ void Renderer::Init()
 	s_data.QuadVertexPositions[3] = Vector2(0.5f, 0.5f);
 
 	s_data.TextureSlots = MakeScope<const Texture2D*[]>(m_numberOfTextureUnits);
+	s_data.NumberOfTextureSlots = (uint32)m_numberOfTextureUnits;
 	s_data.TextureSlots[0] = s_data.WhiteTexture.get();
 
+	s_data.QuadCommands.reserve(s_data.MaxQuads);
+	s_data.QuadSortEntries.reserve(s_data.MaxQuads);
+	s_data.QuadSortScratch.reserve(s_data.MaxQuads);
+
 	std::stringstream ss;
 	ss << std::this_thread::get_id();
 	GARBAGE_CORE_INFO("Renderer initialized on thread {}", ss.str());
@@ -250,25 +441,62 @@ void Renderer::SetViewportSize(Vector2 viewportSize)
 
 void Renderer::BeginNewFrame(const Matrix4& projection, const Matrix4& view)
 {
+	GARBAGE_PROFILE_FRAME();
+
 	s_statistics.Reset();
 	s_rendererTimer.Reset();
 
+	GpuTimer::BeginFrame();
+	s_statistics.GpuTime = GpuTimer::GetFrameMilliseconds();
+
+	m_frameAllocator.NextFrame();
+	MemoryStatistics::CaptureFrame();
+
 	s_data.Projection = projection;
 	s_data.View = view;
 	s_data.ViewProjection = projection * view;
 
-	StartBatch();
+	s_data.QuadCommands.clear();
+	s_data.QuadSortEntries.clear();
 }
 
 void Renderer::EndFrame()
 {
-	FlushBatch();
+	GARBAGE_CORE_PROFILE_FUNCTION();
+
+	Flush();
+	GpuTimer::EndFrame();
 
 	s_statistics.FrameTime = s_rendererTimer.GetElapsedMilliseconds();
+
+	s_frameHistory[s_frameHistoryHead] = s_statistics;
+	s_frameHistoryHead = (s_frameHistoryHead + 1) % FrameHistorySize;
+	s_numberOfRecordedFrames = std::min(s_numberOfRecordedFrames + 1, FrameHistorySize);
+
+	GARBAGE_PROFILE_COUNTER("Draw calls", s_statistics.DrawCalls);
+	GARBAGE_PROFILE_COUNTER("Quads", s_statistics.QuadCount);
+}
+
+void Renderer::Flush()
+{
+	if (s_data.QuadCommands.empty()) return;
+
+	Timer submissionTimer;
+
+	StartBatch();
+	SubmitQuadCommands();
+	FlushBatch();
+
+	s_data.QuadCommands.clear();
+	s_data.QuadSortEntries.clear();
+
+	s_statistics.SubmissionTime += submissionTimer.GetElapsedMilliseconds();
 }
 
 void Renderer::DrawVertexArray(const VertexArray& vertexArray)
 {
+	Flush();
+
 	vertexArray.Bind();
 
 	glDrawArrays(GL_TRIANGLES, 0, vertexArray.GetNumberOfVertices());
@@ -284,6 +512,8 @@ void Renderer::DrawVertexArray(const VertexArray& vertexArray, const IndexBuffer
 
 void Renderer::DrawVertexArray(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, uint64 size)
 {
+	Flush();
+
 	vertexArray.Bind();
 	indexBuffer.Bind();
 
@@ -294,98 +524,89 @@ void Renderer::DrawVertexArray(const VertexArray& vertexArray, const IndexBuffer
 
 void Renderer::DrawQuad(const Matrix4& transform, const Color& color, const Texture2D* texture, float tiling)
 {
-	static const Vector2 textureCoords[] = { { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
-
-	if (s_data.QuadIndexCount + QuadIndexCount >= Renderer2DData::MaxIndices) NextBatch();
-
-	uint32 textureIndex = 0;
-
-	if (texture)
-	{
-		if (s_data.TextureSlotIndex >= m_numberOfTextureUnits)
-		{
-			NextBatch();
-
-			textureIndex = 1;
-			s_data.TextureSlots[s_data.TextureSlotIndex++] = texture;
-		}
-		else
-		{
-			const uint32 numberOfTextures = Math::Min(s_data.TextureSlotIndex, m_numberOfTextureUnits);
+	const Vector4 origin = transform.M[2] + transform.M[3];
+	RecordQuad({ color, Vector2(transform.M[0]), Vector2(transform.M[1]), Vector2(origin), texture, tiling }, origin.Z);
+}
 
-			for (uint32 i = numberOfTextures; i > 0; i--)
-			{
-				if (s_data.TextureSlots[i])
-				{
-					if (*s_data.TextureSlots[i] == *texture)
-					{
-						textureIndex = i;
-						break;
-					}
-				}
-				else
-				{
-					textureIndex = i;
-					s_data.TextureSlotIndex = i;
-					s_data.TextureSlots[s_data.TextureSlotIndex++] = texture;
-
-					break;
-				}
-			}
+void Renderer::DrawQuad(const Matrix4& transform, const TextureAtlasRegion& region, const Color& color)
+{
+	const Vector4 origin = transform.M[2] + transform.M[3];
+	RecordQuad({ color, Vector2(transform.M[0]), Vector2(transform.M[1]), Vector2(origin), region.Texture, 1.0f, region.UVMin, region.UVMax }, origin.Z);
+}
 
-			if (textureIndex == 0)
-			{
-				NextBatch();
+void Renderer::DrawQuad(const Transform2D& transform, const Color& color, const Texture2D* texture, float tiling)
+{
+	RecordQuad({ color, transform.AxisX, transform.AxisY, transform.Translation, texture, tiling }, 0.0f);
+}
 
-				textureIndex = s_data.TextureSlotIndex;
-				s_data.TextureSlots[s_data.TextureSlotIndex++] = texture;
-			}
-		}
-	}
+void Renderer::DrawQuad(const Transform2D& transform, const TextureAtlasRegion& region, const Color& color)
+{
+	RecordQuad({ color, transform.AxisX, transform.AxisY, transform.Translation, region.Texture, 1.0f, region.UVMin, region.UVMax }, 0.0f);
+}
 
-	for (uint64 i = 0; i < QuadVertexCount; i++)
+void Renderer::DrawQuad(Vector2 position, Vector2 size, float rotation, const Color& color, const Texture2D* texture, float tiling)
+{
+	if (rotation == 0.0f)
 	{
-		s_data.QuadVertexBufferPtr->Position = transform * Vector4(s_data.QuadVertexPositions[i], 1.0f, 1.0f);
-		s_data.QuadVertexBufferPtr->Color = color;
-		s_data.QuadVertexBufferPtr->TexIndex = (float)textureIndex;
-		s_data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-		s_data.QuadVertexBufferPtr->Tiling = tiling;
-		s_data.QuadVertexBufferPtr++;
+		RecordQuad({ color, Vector2(size.X, 0.0f), Vector2(0.0f, size.Y), position, texture, tiling }, 0.0f);
+		return;
 	}
 
-	s_data.QuadIndexCount += 6;
+	const float sin = Math::Sin(rotation);
+	const float cos = Math::Cos(rotation);
 
-	s_statistics.QuadCount++;
+	RecordQuad({ color, Vector2(cos * size.X, sin * size.X), Vector2(-sin * size.Y, cos * size.Y), position, texture, tiling }, 0.0f);
 }
 
 void Renderer::EnableFeature(Renderer::Feature feature)
 {
+	Flush();
+
+	if (feature == Renderer::Feature::AlphaBlending) s_data.AlphaBlending = true;
+
 	if (feature != Renderer::Feature::WriteToDepthBuffer) glEnable(GarbageEngineRenderingFeatureToOpenGL(feature));
 	else glDepthMask(GL_TRUE);
 }
 
 void Renderer::DisableFeature(Renderer::Feature feature)
 {
+	Flush();
+
+	if (feature == Renderer::Feature::AlphaBlending) s_data.AlphaBlending = false;
+
 	if (feature != Renderer::Feature::WriteToDepthBuffer) glDisable(GarbageEngineRenderingFeatureToOpenGL(feature));
 	else glDepthMask(GL_FALSE);
 }
 
 void Renderer::SetBlendMode(BlendMode blendMode)
 {
-	switch (blendMode)
-	{
-		case Renderer::BlendMode::Default: glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); break;
-		case Renderer::BlendMode::Additive:glBlendFunc(GL_SRC_ALPHA, GL_ONE); break;
-	}
+	Flush();
+
+	s_data.BlendMode = blendMode;
+	SetOpenGLBlendFunction(blendMode);
+}
+
+void Renderer::SetLayer(uint8 layer)
+{
+	s_data.Layer = layer;
+}
+
+uint8 Renderer::GetLayer() const
+{
+	return s_data.Layer;
 }
 
 void Renderer::SetDepthFunction(DepthFunction depthFunction)
 {
+	Flush();
+
 	glDepthFunc(GarbageEngineRenderingDepthFunctionToOpenGL(depthFunction));
 }
 
 void Renderer::SetFaceCullingMode(FaceCullingMode mode)
 {
+	Flush();
+
 	glCullFace(mode == FaceCullingMode::ClockWise ? GL_CW : GL_CCW);
 }
 
@@ -394,12 +615,97 @@ const Renderer::Statistics& Renderer::GetStatistics() const
 	return s_statistics;
 }
 
+uint32 Renderer::GetNumberOfRecordedFrames() const
+{
+	return s_numberOfRecordedFrames;
+}
+
+const Renderer::Statistics& Renderer::GetRecordedFrame(uint32 framesAgo) const
+{
+	GARBAGE_CORE_ASSERT(framesAgo < s_numberOfRecordedFrames);
+
+	return s_frameHistory[(s_frameHistoryHead + FrameHistorySize - 1 - framesAgo) % FrameHistorySize];
+}
+
+Renderer::FrameSummary Renderer::GetFrameSummary(FrameMetric metric) const
+{
+	FrameSummary summary;
+	if (s_numberOfRecordedFrames == 0) return summary;
+
+	float values[FrameHistorySize];
+	float sum = 0.0f;
+
+	for (uint32 i = 0; i < s_numberOfRecordedFrames; i++)
+	{
+		const Statistics& frame = GetRecordedFrame(i);
+
+		switch (metric)
+		{
+			case FrameMetric::FrameTime: values[i] = frame.FrameTime; break;
+			case FrameMetric::SubmissionTime: values[i] = frame.SubmissionTime; break;
+			case FrameMetric::GpuTime: values[i] = frame.GpuTime; break;
+			case FrameMetric::DrawCalls: values[i] = (float)frame.DrawCalls; break;
+			case FrameMetric::QuadCount: values[i] = (float)frame.QuadCount; break;
+			case FrameMetric::VertexStreamStalls: values[i] = (float)frame.VertexStreamStalls; break;
+			case FrameMetric::Flushes: values[i] = (float)frame.Flushes; break;
+			case FrameMetric::TextureBinds: values[i] = (float)frame.TextureBinds; break;
+			case FrameMetric::UploadedBytes: values[i] = (float)frame.UploadedBytes; break;
+		}
+
+		sum += values[i];
+	}
+
+	const uint32 count = s_numberOfRecordedFrames;
+	std::sort(values, values + count);
+
+	// Nearest-rank percentiles
+	auto percentile = [&](float p) { return values[std::max((uint32)Math::Ceil(p * count), 1u) - 1]; };
+
+	summary.Min = values[0];
+	summary.Average = sum / count;
+	summary.P95 = percentile(0.95f);
+	summary.P99 = percentile(0.99f);
+	summary.Max = values[count - 1];
+
+	return summary;
+}
+
+void Renderer::ClearFrameHistory()
+{
+	s_frameHistoryHead = 0;
+	s_numberOfRecordedFrames = 0;
+}
+
+void Renderer::SetQuadRenderingMode(QuadRenderingMode mode)
+{
+	s_data.QuadRenderingMode = mode;
+}
+
+Renderer::QuadRenderingMode Renderer::GetQuadRenderingMode() const
+{
+	return s_data.QuadRenderingMode;
+}
+
 void Renderer::StartBatch()
 {
 	s_data.QuadIndexCount = 0;
-	s_data.QuadVertexBufferPtr = s_data.QuadVertexBufferBase.get();
 
-	for (uint32 i = 1; i < m_numberOfTextureUnits; i++)
+	if (s_data.QuadRenderingMode == QuadRenderingMode::Instanced)
+	{
+		s_data.QuadInstanceBufferBase = (QuadInstance*)s_data.QuadInstanceBuffer->MapStreamRegion();
+		s_data.QuadInstanceBufferPtr = s_data.QuadInstanceBufferBase;
+
+		if (s_data.QuadInstanceBuffer->HasStalledOnLastMap()) s_statistics.VertexStreamStalls++;
+	}
+	else
+	{
+		s_data.QuadVertexBufferBase = (QuadVertex*)s_data.QuadVertexBuffer->MapStreamRegion();
+		s_data.QuadVertexBufferPtr = s_data.QuadVertexBufferBase;
+
+		if (s_data.QuadVertexBuffer->HasStalledOnLastMap()) s_statistics.VertexStreamStalls++;
+	}
+
+	for (uint32 i = 1; i < s_data.NumberOfTextureSlots; i++)
 	{
 		s_data.TextureSlots[i] = nullptr;
 	}
@@ -409,20 +715,63 @@ void Renderer::StartBatch()
 
 void Renderer::FlushBatch()
 {
+	GARBAGE_CORE_PROFILE_FUNCTION();
+
+	const bool instanced = s_data.QuadRenderingMode == QuadRenderingMode::Instanced;
+	VertexBuffer& buffer = instanced ? *s_data.QuadInstanceBuffer : *s_data.QuadVertexBuffer;
+
+	uint32 dataSize = instanced
+		? (uint32)((uint8*)s_data.QuadInstanceBufferPtr - (uint8*)s_data.QuadInstanceBufferBase)
+		: (uint32)((uint8*)s_data.QuadVertexBufferPtr - (uint8*)s_data.QuadVertexBufferBase);
+	buffer.UnmapStreamRegion(dataSize);
+
+	s_statistics.Flushes++;
+	s_statistics.UploadedBytes += dataSize;
+
+	s_data.QuadVertexBufferBase = nullptr;
+	s_data.QuadVertexBufferPtr = nullptr;
+	s_data.QuadInstanceBufferBase = nullptr;
+	s_data.QuadInstanceBufferPtr = nullptr;
+
 	if (s_data.QuadIndexCount)
 	{
-		uint32 dataSize = (uint32)((uint8*)s_data.QuadVertexBufferPtr - (uint8*)s_data.QuadVertexBufferBase.get());
-		s_data.QuadVertexBuffer->UpdateData(s_data.QuadVertexBufferBase.get(), dataSize);
-
 		for (uint32 i = 0; i < s_data.TextureSlotIndex; i++)
 		{
-			if (s_data.TextureSlots[i]) s_data.TextureSlots[i]->Bind((uint8)i);
+			if (s_data.TextureSlots[i])
+			{
+				s_data.TextureSlots[i]->Bind((uint8)i);
+				s_statistics.TextureBinds++;
+			}
+		}
+
+		const Shader& shader = instanced ? *s_data.QuadInstanceShader : *s_data.QuadShader;
+
+		shader.Bind();
+		shader.SetMatrix4(shader.GetUniformLocation(Shader::CachedUniform::ViewProjection), s_data.ViewProjection);
+
+		const uint32 quadCount = s_data.QuadIndexCount / QuadIndexCount;
+		const uint32 gpuScope = GpuTimer::BeginScope("Quad batch");
+
+		if (instanced)
+		{
+			s_data.QuadInstanceVertexArrays[buffer.GetCurrentStreamRegion()]->Bind();
+
+			glDrawArraysInstanced(GL_TRIANGLES, 0, QuadIndexCount, (GLsizei)quadCount);
+		}
+		else
+		{
+			s_data.QuadVertexArray->Bind();
+			s_data.QuadIndexBuffer->Bind();
+
+			glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)s_data.QuadIndexCount, GL_UNSIGNED_INT, nullptr, (GLint)buffer.GetStreamRegionBaseVertex());
 		}
 
-		s_data.QuadShader->Bind();
-		s_data.QuadShader->SetMatrix4(s_data.QuadShader->GetUniformLocation(Shader::CachedUniform::ViewProjection), s_data.ViewProjection);
-		DrawVertexArray(*s_data.QuadVertexArray, *s_data.QuadIndexBuffer, dataSize);
-		s_statistics.TotalNumberOfVertices += dataSize / sizeof(QuadVertex);
+		GpuTimer::EndScope(gpuScope);
+
+		buffer.AdvanceStreamRegion();
+
+		s_statistics.DrawCalls++;
+		s_statistics.TotalNumberOfVertices += quadCount * QuadVertexCount;
 	}
 }
 
@@ -431,3 +780,114 @@ void Renderer::NextBatch()
 	FlushBatch();
 	StartBatch();
 }
+
+void Renderer::RecordQuad(const QuadCommand& command, float depth)
+{
+	// Radix sort is stable, so blended quads at the same depth are drawn in submission order
+	const uint64 textureId = command.Texture && !s_data.AlphaBlending ? command.Texture->GetInternalId() : 0;
+	const uint64 key = ((uint64)s_data.Layer << QuadSortKeyLayerShift)
+		| (((uint64)s_data.BlendMode & QuadSortKeyBlendModeMask) << QuadSortKeyBlendModeShift)
+		| ((textureId & QuadSortKeyTextureMask) << QuadSortKeyTextureShift)
+		| (uint64)FloatToSortableBits(depth);
+
+	s_data.QuadSortEntries.push_back({ key, (uint32)s_data.QuadCommands.size() });
+	s_data.QuadCommands.push_back(command);
+
+	s_statistics.QuadCount++;
+}
+
+uint32 Renderer::FindOrAddTextureSlot(const Texture2D* texture)
+{
+	if (!texture) return 0;
+
+	// Opaque commands are sorted by texture, so the wanted texture is almost always in the last used slot
+	for (uint32 i = s_data.TextureSlotIndex - 1; i > 0; i--)
+	{
+		if (*s_data.TextureSlots[i] == *texture) return i;
+	}
+
+	if (s_data.TextureSlotIndex >= s_data.NumberOfTextureSlots) NextBatch();
+
+	s_data.TextureSlots[s_data.TextureSlotIndex] = texture;
+	return s_data.TextureSlotIndex++;
+}
+
+void Renderer::SubmitQuadCommands()
+{
+	static const Vector2 textureCoords[] = { { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
+
+	if (s_data.QuadCommands.empty()) return;
+
+	GARBAGE_CORE_PROFILE_FUNCTION();
+
+	RadixSort(s_data.QuadSortEntries, s_data.QuadSortScratch);
+
+	BlendMode batchBlendMode = s_data.BlendMode;
+
+	// Only the axes and the origin change between quads, the rest of the transform stays zero
+	Matrix4 transform(0.0f);
+	Vector4 positions[QuadVertexCount];
+
+	for (auto& entry : s_data.QuadSortEntries)
+	{
+		const QuadCommand& command = s_data.QuadCommands[entry.Index];
+
+		const BlendMode blendMode = (BlendMode)((entry.Key >> QuadSortKeyBlendModeShift) & QuadSortKeyBlendModeMask);
+		if (blendMode != batchBlendMode)
+		{
+			NextBatch();
+			SetOpenGLBlendFunction(blendMode);
+			batchBlendMode = blendMode;
+		}
+
+		if (s_data.QuadIndexCount + QuadIndexCount >= Renderer2DData::MaxIndices) NextBatch();
+
+		const float textureIndex = (float)FindOrAddTextureSlot(command.Texture);
+
+		if (s_data.QuadRenderingMode == QuadRenderingMode::Instanced)
+		{
+			QuadInstance instance;
+			instance.Origin = command.Origin;
+			instance.Axes[0] = command.AxisX.X;
+			instance.Axes[1] = command.AxisX.Y;
+			instance.Axes[2] = command.AxisY.X;
+			instance.Axes[3] = command.AxisY.Y;
+			instance.UVRect[0] = PackUnorm16(command.UVMin.X);
+			instance.UVRect[1] = PackUnorm16(command.UVMin.Y);
+			instance.UVRect[2] = PackUnorm16(command.UVMax.X);
+			instance.UVRect[3] = PackUnorm16(command.UVMax.Y);
+			instance.Color = command.Color.GetAsPackedRGBA8();
+			instance.TextureIndexAndTiling[0] = Half(textureIndex);
+			instance.TextureIndexAndTiling[1] = Half(command.Tiling);
+
+			*s_data.QuadInstanceBufferPtr++ = instance;
+			s_data.QuadIndexCount += QuadIndexCount;
+
+			continue;
+		}
+
+		transform.M[0] = Vector4(command.AxisX, 0.0f, 0.0f);
+		transform.M[1] = Vector4(command.AxisY, 0.0f, 0.0f);
+		transform.M[3] = Vector4(command.Origin, 0.0f, 1.0f);
+
+		TransformPoints(transform, s_data.QuadVertexPositions, positions, QuadVertexCount);
+
+		for (uint64 i = 0; i < QuadVertexCount; i++)
+		{
+			s_data.QuadVertexBufferPtr->Position = positions[i];
+			s_data.QuadVertexBufferPtr->Color = command.Color;
+			s_data.QuadVertexBufferPtr->TexIndex = textureIndex;
+			s_data.QuadVertexBufferPtr->TexCoord = command.UVMin + (command.UVMax - command.UVMin) * textureCoords[i];
+			s_data.QuadVertexBufferPtr->Tiling = command.Tiling;
+			s_data.QuadVertexBufferPtr++;
+		}
+
+		s_data.QuadIndexCount += QuadIndexCount;
+	}
+
+	if (batchBlendMode != s_data.BlendMode)
+	{
+		NextBatch();
+		SetOpenGLBlendFunction(s_data.BlendMode);
+	}
+}
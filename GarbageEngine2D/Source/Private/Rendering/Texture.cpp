@@ -135,6 +135,7 @@ Texture::Format Texture::FormatFromNumberOfColorChannels(uint8 numberOfColorChan
 
 Texture::~Texture()
 {
+	UpdateMemoryInfo(0);
 	glDeleteTextures(1, &m_id);
 }
 
@@ -181,9 +182,8 @@ bool Texture::Setup(const Specification& specification)
 
 void Texture::UpdateMemoryInfo(uint64 size)
 {
-	MemoryStatistics::Get().m_vramUsedForTextures -= m_sizeInVRam;
+	MemoryStatistics::Resized(MemoryDomain::GPU, MemoryCategory::Textures, m_sizeInVRam, size);
 	m_sizeInVRam = size;
-	MemoryStatistics::Get().m_vramUsedForTextures += size;
 }
 
 
@@ -211,4 +211,11 @@ void Texture2D::SetData(void* data, uint32 dataSize)
 	const uint32 exceptedDataSize = GetWidth() * GetHeight() * GetTextureFormatSize(GetFormat());
 	GARBAGE_CORE_ASSERT(dataSize == exceptedDataSize);
 	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, GetWidth(), GetHeight(), GetConvertedFormat(), GL_UNSIGNED_BYTE, data));
+}
+
+void Texture2D::SetSubData(uint16 x, uint16 y, uint16 width, uint16 height, const void* data)
+{
+	GARBAGE_CORE_ASSERT((uint32)x + width <= GetWidth() && (uint32)y + height <= GetHeight());
+	Bind(0);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GetConvertedFormat(), GL_UNSIGNED_BYTE, data));
 }
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "Rendering/TextureAtlas.h"
+#include "Core/Assert.h"
+#include "Core/Asset/Texture2D.h"
+#include "Core/Asset/TextureAtlasAsset.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+SkylinePacker::SkylinePacker(uint16 width, uint16 height) : m_width(width), m_height(height)
+{
+	Clear();
+}
+
+bool SkylinePacker::Pack(uint16 width, uint16 height, uint16& outX, uint16& outY)
+{
+	if (width == 0 || height == 0 || width > m_width || height > m_height) return false;
+
+	uint64 bestIndex = std::numeric_limits<uint64>::max();
+	uint32 bestTop = std::numeric_limits<uint32>::max();
+	uint16 bestWidth = std::numeric_limits<uint16>::max();
+	uint16 bestY = 0;
+
+	for (uint64 i = 0; i < m_skyline.size(); i++)
+	{
+		uint16 y = 0;
+		if (!Fits(i, width, height, y)) continue;
+
+		const uint32 top = (uint32)y + height;
+		if (top < bestTop || (top == bestTop && m_skyline[i].Width < bestWidth))
+		{
+			bestIndex = i;
+			bestTop = top;
+			bestWidth = m_skyline[i].Width;
+			bestY = y;
+		}
+	}
+
+	if (bestIndex == std::numeric_limits<uint64>::max()) return false;
+
+	outX = m_skyline[bestIndex].X;
+	outY = bestY;
+
+	m_skyline.insert(m_skyline.begin() + bestIndex, { outX, (uint16)bestTop, width });
+
+	// Cut the nodes that are now covered by the new one
+	for (uint64 i = bestIndex + 1; i < m_skyline.size();)
+	{
+		const Node& previous = m_skyline[i - 1];
+		const uint16 previousEnd = previous.X + previous.Width;
+
+		if (m_skyline[i].X >= previousEnd) break;
+
+		const uint16 shrink = previousEnd - m_skyline[i].X;
+		if (m_skyline[i].Width <= shrink)
+		{
+			m_skyline.erase(m_skyline.begin() + i);
+			continue;
+		}
+
+		m_skyline[i].X += shrink;
+		m_skyline[i].Width -= shrink;
+		break;
+	}
+
+	for (uint64 i = 0; i + 1 < m_skyline.size();)
+	{
+		if (m_skyline[i].Y == m_skyline[i + 1].Y)
+		{
+			m_skyline[i].Width += m_skyline[i + 1].Width;
+			m_skyline.erase(m_skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	m_usedArea += (uint64)width * (uint64)height;
+
+	return true;
+}
+
+void SkylinePacker::Clear()
+{
+	m_skyline.clear();
+	m_skyline.push_back({ 0, 0, m_width });
+	m_usedArea = 0;
+}
+
+bool SkylinePacker::Fits(uint64 index, uint16 width, uint16 height, uint16& outY) const
+{
+	if ((uint32)m_skyline[index].X + width > m_width) return false;
+
+	int32 widthLeft = width;
+	uint16 y = m_skyline[index].Y;
+
+	for (uint64 i = index; widthLeft > 0; i++)
+	{
+		y = std::max(y, m_skyline[i].Y);
+		if ((uint32)y + height > m_height) return false;
+
+		widthLeft -= m_skyline[i].Width;
+	}
+
+	outY = y;
+	return true;
+}
+
+
+
+TextureAtlas::TextureAtlas(const Specification& specification) : m_specification(specification)
+{
+	GARBAGE_CORE_ASSERT(specification.MaxRegionSize + 2 * specification.Padding <= specification.PageSize,
+		"Max region size does not fit into atlas page of size {}", specification.PageSize);
+}
+
+TextureAtlas::TextureAtlas(const TextureAtlasAsset& asset)
+{
+	m_specification.PageSize = asset.GetPageSize();
+	m_specification.Padding = asset.GetPadding();
+	m_specification.Filtering = asset.Filtering;
+
+	// Free space of cooked pages is unknown, regions added at runtime always go to new pages
+	for (uint64 i = 0; i < asset.GetNumberOfPages(); i++)
+	{
+		AddPage(asset.GetPageData(i)).Cooked = true;
+	}
+
+	const float pageSize = (float)m_specification.PageSize;
+
+	for (auto& region : asset.GetRegions())
+	{
+		TextureAtlasRegion& atlasRegion = m_regions[region.Name];
+		atlasRegion.Texture = m_pages[region.Page].Texture.get();
+		atlasRegion.UVMin = Vector2((float)region.X / pageSize, (float)region.Y / pageSize);
+		atlasRegion.UVMax = Vector2((float)(region.X + region.Width) / pageSize, (float)(region.Y + region.Height) / pageSize);
+	}
+}
+
+const TextureAtlasRegion* TextureAtlas::Add(std::string_view name, const Texture2DAsset& texture)
+{
+	return Add(name, texture.GetData(), (uint16)texture.GetSize().X, (uint16)texture.GetSize().Y, texture.GetNumberOfColorChannels());
+}
+
+const TextureAtlasRegion* TextureAtlas::Add(std::string_view name, const uint8* data, uint16 width, uint16 height, uint8 numberOfColorChannels)
+{
+	if (auto region = Find(name)) return region;
+
+	if (width > m_specification.MaxRegionSize || height > m_specification.MaxRegionSize) return nullptr;
+
+	const uint16 padding = m_specification.Padding;
+	const uint16 paddedWidth = width + 2 * padding;
+	const uint16 paddedHeight = height + 2 * padding;
+
+	Page* page = nullptr;
+	uint16 x = 0, y = 0;
+
+	for (auto& existingPage : m_pages)
+	{
+		if (!existingPage.Cooked && existingPage.Packer.Pack(paddedWidth, paddedHeight, x, y))
+		{
+			page = &existingPage;
+			break;
+		}
+	}
+
+	if (!page)
+	{
+		page = &AddPage();
+
+		bool packed = page->Packer.Pack(paddedWidth, paddedHeight, x, y);
+		GARBAGE_CORE_ASSERT(packed, "Region does not fit into an empty atlas page: {}", name);
+	}
+
+	std::vector<uint8> pixels((uint64)paddedWidth * (uint64)paddedHeight * 4);
+	CopyToPage(pixels.data(), paddedWidth, 0, 0, padding, data, width, height, numberOfColorChannels);
+
+	page->Texture->SetSubData(x, y, paddedWidth, paddedHeight, pixels.data());
+
+	const float pageSize = (float)m_specification.PageSize;
+
+	TextureAtlasRegion& region = m_regions[std::string(name)];
+	region.Texture = page->Texture.get();
+	region.UVMin = Vector2((float)(x + padding) / pageSize, (float)(y + padding) / pageSize);
+	region.UVMax = Vector2((float)(x + padding + width) / pageSize, (float)(y + padding + height) / pageSize);
+
+	return &region;
+}
+
+const TextureAtlasRegion* TextureAtlas::Find(std::string_view name) const
+{
+	auto it = m_regions.find(std::string(name));
+	return it != m_regions.end() ? &it->second : nullptr;
+}
+
+void TextureAtlas::CopyToPage(uint8* page, uint16 pageWidth, uint16 x, uint16 y, uint16 padding,
+	const uint8* data, uint16 width, uint16 height, uint8 numberOfColorChannels)
+{
+	GARBAGE_CORE_ASSERT(numberOfColorChannels == 1 || numberOfColorChannels == 3 || numberOfColorChannels == 4);
+
+	const uint64 pitch = (uint64)pageWidth * 4;
+
+	auto pixelAt = [&](int32 column, int32 row) -> uint8*
+	{
+		return page + (uint64)(y + row) * pitch + (uint64)(x + column) * 4;
+	};
+
+	for (int32 row = 0; row < height; row++)
+	{
+		const uint8* source = data + (uint64)row * width * numberOfColorChannels;
+		uint8* destination = pixelAt(padding, padding + row);
+
+		if (numberOfColorChannels == 4)
+		{
+			std::memcpy(destination, source, (uint64)width * 4);
+			continue;
+		}
+
+		for (int32 column = 0; column < width; column++, source += numberOfColorChannels, destination += 4)
+		{
+			if (numberOfColorChannels == 1)
+			{
+				destination[0] = destination[1] = destination[2] = source[0];
+			}
+			else
+			{
+				destination[0] = source[0];
+				destination[1] = source[1];
+				destination[2] = source[2];
+			}
+
+			destination[3] = 255;
+		}
+	}
+
+	if (padding == 0 || width == 0 || height == 0) return;
+
+	// Extrude left and right borders, then copy whole top and bottom rows including the extruded corners
+	for (int32 row = padding; row < padding + height; row++)
+	{
+		for (int32 i = 0; i < padding; i++)
+		{
+			std::memcpy(pixelAt(i, row), pixelAt(padding, row), 4);
+			std::memcpy(pixelAt(padding + width + i, row), pixelAt(padding + width - 1, row), 4);
+		}
+	}
+
+	const uint64 paddedRowSize = ((uint64)width + 2 * (uint64)padding) * 4;
+
+	for (int32 i = 0; i < padding; i++)
+	{
+		std::memcpy(pixelAt(0, i), pixelAt(0, padding), paddedRowSize);
+		std::memcpy(pixelAt(0, padding + height + i), pixelAt(0, padding + height - 1), paddedRowSize);
+	}
+}
+
+TextureAtlas::Page& TextureAtlas::AddPage(void* data)
+{
+	Texture::Specification specification;
+	specification.Width = m_specification.PageSize;
+	specification.Height = m_specification.PageSize;
+	specification.Format = Texture::Format::RGBA8;
+	specification.WrapMode = Texture::WrapMode::ClampToEdge;
+	specification.MinFiltering = m_specification.Filtering;
+	specification.MagFiltering = m_specification.Filtering;
+	// Mip levels would mix neighbouring regions together
+	specification.GenerateMipmaps = false;
+	specification.Data = data;
+
+	m_pages.push_back({ MakeRef<Texture2D>(specification), SkylinePacker(m_specification.PageSize, m_specification.PageSize) });
+	return m_pages.back();
+}
\ No newline at end of file
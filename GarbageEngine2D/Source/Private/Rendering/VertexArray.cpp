@@ -10,6 +10,8 @@ static constexpr uint32 GetSizeOfType(uint32 type)
 		case GL_FLOAT: return sizeof(GLfloat);
 		case GL_UNSIGNED_INT: return sizeof(GLuint);
 		case GL_UNSIGNED_BYTE: return sizeof(GLubyte);
+		case GL_UNSIGNED_SHORT: return sizeof(GLushort);
+		case GL_HALF_FLOAT: return sizeof(GLhalf);
 	}
 
 	GARBAGE_CORE_ASSERT(false, "Get size of type failed: passed unknown type {}!", type);
@@ -27,13 +29,12 @@ VertexArray::~VertexArray()
 	glDeleteVertexArrays(1, &m_id);
 }
 
-void VertexArray::AddBuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout)
+void VertexArray::AddBuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout, uint64 offset)
 {
 	Bind();
 	vertexBuffer.Bind();
 
 	const auto& elements = layout.GetElements();
-	uint64 offset = 0;
 	for (uint32 i = 0; i < elements.size(); i++)
 	{
 		const auto& element = elements[i];
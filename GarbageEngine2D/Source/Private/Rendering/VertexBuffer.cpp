@@ -1,6 +1,11 @@
 #include "Rendering/VertexBuffer.h"
+#include "Core/Assert.h"
+#include "Memory/Statistics.h"
 #include <glad/glad.h>
 
+// 1 ms
+static constexpr GLuint64 StreamFenceWaitTimeout = 1000000;
+
 VertexBuffer::VertexBuffer(const void* data, uint32 size, uint32 count, bool dynamic, bool instanced) : m_dynamic(dynamic), m_instanced(instanced), m_count(count)
 {
 	glGenBuffers(1, &m_id);
@@ -8,11 +13,37 @@ VertexBuffer::VertexBuffer(const void* data, uint32 size, uint32 count, bool dyn
 	m_size = size;
 	m_usage = dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
 	glBufferData(GL_ARRAY_BUFFER, size, data, m_usage);
+
+	MemoryStatistics::Allocated(MemoryDomain::GPU, MemoryCategory::VertexBuffers, m_size);
+}
+
+VertexBuffer::VertexBuffer(uint32 regionSize, uint32 count, uint8 numberOfRegions, bool instanced) : m_dynamic(true), m_instanced(instanced), m_count(count),
+	m_numberOfStreamRegions(numberOfRegions), m_streamRegionSize(regionSize)
+{
+	GARBAGE_CORE_ASSERT(numberOfRegions > 0, "Streaming vertex buffer must have at least one region!");
+
+	m_streamFences = MakeScope<void*[]>(numberOfRegions);
+	for (uint8 i = 0; i < numberOfRegions; i++) m_streamFences[i] = nullptr;
+
+	glGenBuffers(1, &m_id);
+	Bind();
+	m_size = regionSize * numberOfRegions;
+	m_usage = GL_STREAM_DRAW;
+	glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, m_usage);
+
+	MemoryStatistics::Allocated(MemoryDomain::GPU, MemoryCategory::VertexBuffers, m_size);
 }
 
 VertexBuffer::~VertexBuffer()
 {
+	for (uint8 i = 0; i < m_numberOfStreamRegions; i++)
+	{
+		if (m_streamFences[i]) glDeleteSync((GLsync)m_streamFences[i]);
+	}
+
 	glDeleteBuffers(1, &m_id);
+
+	MemoryStatistics::Freed(MemoryDomain::GPU, MemoryCategory::VertexBuffers, m_size);
 }
 
 void VertexBuffer::Bind() const
@@ -29,6 +60,63 @@ void VertexBuffer::UpdateData(const void* data, uint32 size)
 	// So I'll clear the buffer anyway...
  
 	glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, m_usage);
+	MemoryStatistics::Resized(MemoryDomain::GPU, MemoryCategory::VertexBuffers, m_size, size);
 	m_size = size;
 	glBufferData(GL_ARRAY_BUFFER, size, data, m_usage);
 }
+
+void* VertexBuffer::MapStreamRegion()
+{
+	GARBAGE_CORE_ASSERT(IsStreaming(), "Only streaming vertex buffers can be mapped!");
+
+	m_stalledOnLastMap = false;
+
+	GLsync fence = (GLsync)m_streamFences[m_currentStreamRegion];
+	if (fence)
+	{
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			m_stalledOnLastMap = true;
+
+			do
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, StreamFenceWaitTimeout);
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+
+		GARBAGE_CORE_ASSERT(result != GL_WAIT_FAILED, "Waiting for vertex stream fence failed!");
+
+		glDeleteSync(fence);
+		m_streamFences[m_currentStreamRegion] = nullptr;
+	}
+
+	Bind();
+
+	// The fence guarantees that GPU doesn't read from this region anymore, so there is no need for the driver to synchronize
+	void* data = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)m_currentStreamRegion * m_streamRegionSize, m_streamRegionSize,
+		GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+
+	GARBAGE_CORE_ASSERT(data, "Can't map vertex stream region {}!", m_currentStreamRegion);
+
+	return data;
+}
+
+void VertexBuffer::UnmapStreamRegion(uint32 size)
+{
+	GARBAGE_CORE_ASSERT(size <= m_streamRegionSize);
+
+	Bind();
+
+	if (size > 0) glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, size);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void VertexBuffer::AdvanceStreamRegion()
+{
+	GARBAGE_CORE_ASSERT(!m_streamFences[m_currentStreamRegion]);
+
+	m_streamFences[m_currentStreamRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_currentStreamRegion = (m_currentStreamRegion + 1) % m_numberOfStreamRegions;
+}
@@ -1,39 +1,48 @@
 #pragma once
 
 #include "Core/Base.h"
-#include <queue>
+#include <atomic>
 #include <functional>
-#include <mutex>
 
+// Multi-producer, single-consumer queue of actions. Any thread can add actions without locking,
+// the owning thread takes the whole batch at once and runs it in the order it was added
 class GARBAGE_API ActionPool final
 {
 public:
 
 	using Action = std::function<void()>;
 
-	ActionPool() = default;
+	ActionPool(uint32 capacity = 256);
+	~ActionPool();
 
-	FORCEINLINE void AddAction(Action action)
-	{
-		std::scoped_lock<std::mutex> scopedLock(m_mutex);
-		m_queue.push(action);
-	}
+	void AddAction(Action action);
 
-	void Execute()
-	{
-		std::scoped_lock<std::mutex> scopedLock(m_mutex);
+	// Must be called only from the owning thread. Actions added while executing run on the next call
+	void Execute();
 
-		while (!m_queue.empty())
-		{
-			auto& action = m_queue.front();
-			action();
-			m_queue.pop();
-		}
-	}
+	NON_COPYABLE(ActionPool)
 
 private:
 
-	std::queue<Action> m_queue;
-	std::mutex m_mutex;
+	static constexpr uint32 HeapNode = 0xFFFFFFFF;
+
+	struct Node
+	{
+		Action Function;
+		Node* Next{ nullptr };
+		std::atomic<uint32> NextFree{ 0 };
+		uint32 Index{ HeapNode };
+	};
+
+	// Preallocated nodes, actions fall back to heap nodes when all of them are in use
+	Scope<Node[]> m_nodes;
+	uint32 m_capacity;
+
+	// Lower 32 bits are index + 1 of the first free node (0 means empty), upper 32 bits are a tag against ABA
+	std::atomic<uint64> m_freeNodes{ 0 };
+	std::atomic<Node*> m_head{ nullptr };
+
+	Node* AllocateNode();
+	void FreeNode(Node* node);
 
 };
\ No newline at end of file
@@ -3,8 +3,14 @@
 #include "Core/Base.h"
 #include "Core/Assert.h"
 #include "Math/Color.h"
+#include <algorithm>
 #include <vector>
 
+enum class CurveInterpolation
+{
+	Linear, Hermite
+};
+
 class GARBAGE_API AnimationCurve
 {
 public:
@@ -28,6 +34,8 @@ public:
 
 	void AddKeyFrame(const KeyFrame& keyFrame)
 	{
+		m_baked.clear();
+
 		if (m_keyFrames.size() > 0)
 		{
 			if (m_keyFrames[0].Time > keyFrame.Time)
@@ -54,6 +62,72 @@ public:
 	}
 
 	float Evaluate(float time) const
+	{
+		if (!m_baked.empty()) return EvaluateBaked(time);
+
+		return EvaluateKeyFrames(time, CurveInterpolation::Linear);
+	}
+
+	// Key frames may be modified through the returned reference, so the baked table is dropped
+	KeyFrame& GetKeyFrame(uint64 index)
+	{
+		m_baked.clear();
+		return m_keyFrames[index];
+	}
+
+	std::vector<KeyFrame>& GetAllKeyFrames()
+	{
+		m_baked.clear();
+		return m_keyFrames;
+	}
+
+	void ClearKeyFrames()
+	{
+		m_keyFrames.clear();
+		m_baked.clear();
+	}
+
+	// Samples the curve into a table of the given resolution, Evaluate then becomes a single lookup.
+	// Tangents of key frames are only taken into account with Hermite interpolation
+	void Bake(uint32 resolution = 256, CurveInterpolation interpolation = CurveInterpolation::Linear)
+	{
+		GARBAGE_CORE_ASSERT(resolution > 1, "Curve can't be baked with resolution {}", resolution);
+
+		// One extra sample at the end lets the lookup read index + 1 without clamping
+		std::vector<ValueType> baked(resolution + 1);
+		for (uint32 i = 0; i < resolution; i++)
+		{
+			baked[i] = EvaluateKeyFrames((float)i / (float)(resolution - 1), interpolation);
+		}
+		baked[resolution] = baked[resolution - 1];
+
+		m_baked = std::move(baked);
+		m_bakedScale = (float)(resolution - 1);
+		m_bakeResolution = resolution;
+		m_bakeInterpolation = interpolation;
+	}
+
+	// Modifying key frames drops the baked table. This bakes it again with the settings of the last Bake, or the defaults.
+	// Evaluation doesn't do it on demand, since curves are evaluated from several threads
+	void EnsureBaked()
+	{
+		if (m_baked.empty()) Bake(m_bakeResolution, m_bakeInterpolation);
+	}
+
+	bool IsBaked() const { return !m_baked.empty(); }
+
+private:
+
+	using ValueType = float;
+
+	std::vector<KeyFrame> m_keyFrames;
+
+	std::vector<ValueType> m_baked;
+	float m_bakedScale{ 0.0f };
+	uint32 m_bakeResolution{ 256 };
+	CurveInterpolation m_bakeInterpolation{ CurveInterpolation::Linear };
+
+	ValueType EvaluateKeyFrames(float time, CurveInterpolation interpolation) const
 	{
 		time = std::clamp(time, 0.0f, 1.0f);
 
@@ -61,11 +135,11 @@ public:
 		{
 			if (time == 1.0f) return m_keyFrames.back().Value;
 
-			for (uint32 i = 0; i < m_keyFrames.size(); i++)
+			for (uint64 i = 0; i + 1 < m_keyFrames.size(); i++)
 			{
 				if (m_keyFrames[i].Time <= time && m_keyFrames[i + 1].Time >= time)
 				{
-					return EvaluateBetween(time, m_keyFrames[i], m_keyFrames[i + 1]);
+					return EvaluateBetween(time, m_keyFrames[i], m_keyFrames[i + 1], interpolation);
 				}
 			}
 
@@ -81,42 +155,33 @@ public:
 		}
 	}
 
-	KeyFrame& GetKeyFrame(uint64 index)
+	float EvaluateBaked(float time) const
 	{
-		return m_keyFrames[index];
-	}
+		const float position = std::clamp(time, 0.0f, 1.0f) * m_bakedScale;
+		const uint32 index = (uint32)position;
 
-	std::vector<KeyFrame>& GetAllKeyFrames()
-	{
-		return m_keyFrames;
+		return m_baked[index] + (m_baked[index + 1] - m_baked[index]) * (position - (float)index);
 	}
 
-	void ClearKeyFrames()
+	float EvaluateBetween(float t, const KeyFrame& left, const KeyFrame& right, CurveInterpolation interpolation) const
 	{
-		m_keyFrames.clear();
-	}
-
-private:
-
-	std::vector<KeyFrame> m_keyFrames;
+		const float dt = right.Time - left.Time;
+		const float time = (t - left.Time) / dt;
 
-	float EvaluateBetween(float t, const KeyFrame& left, const KeyFrame& right) const
-	{
-		/*float dt = right.Time - left.Time;
+		if (interpolation == CurveInterpolation::Linear) return Math::Lerp(left.Value, right.Value, time);
 
-		float m0 = left.OutTangent * dt;
-		float m1 = right.InTangent * dt;
+		const float m0 = left.OutTangent * dt;
+		const float m1 = right.InTangent * dt;
 
-		float t2 = t * t;
-		float t3 = t2 * t;
+		const float t2 = time * time;
+		const float t3 = t2 * time;
 
-		float a = 2.0f * t3 - 3.0f * t2 + 1.0f;
-		float b = t3 - 2.0f * t2 + t;
-		float c = t3 - t2;
-		float d = -2.0f * t3 + 3.0f * t2;
+		const float a = 2.0f * t3 - 3.0f * t2 + 1.0f;
+		const float b = t3 - 2.0f * t2 + time;
+		const float c = t3 - t2;
+		const float d = -2.0f * t3 + 3.0f * t2;
 
-		return a * left.Value + b * m0 + c * m1 + d * right.Value;*/
-		return Math::Lerp(left.Value, right.Value, (t - left.Time) / (right.Time - left.Time));
+		return a * left.Value + b * m0 + c * m1 + d * right.Value;
 	}
 
 };
@@ -144,6 +209,9 @@ public:
 
 	void AddKeyFrame(const KeyFrame& keyFrame)
 	{
+		m_baked.clear();
+		m_bakedPacked.clear();
+
 		if (m_keyFrames.size() > 0)
 		{
 			if (m_keyFrames[0].Time > keyFrame.Time)
@@ -170,6 +238,98 @@ public:
 	}
 
 	Color Evaluate(float time) const
+	{
+		if (!m_baked.empty()) return EvaluateBaked(time);
+
+		return EvaluateKeyFrames(time, CurveInterpolation::Linear);
+	}
+
+	// Packed the same way as Color::GetAsPackedRGBA8, adjacent baked samples are blended per channel in 8.8 fixed point
+	uint32 EvaluatePacked(float time) const
+	{
+		if (m_bakedPacked.empty()) return Evaluate(time).GetAsPackedRGBA8();
+
+		const float position = std::clamp(time, 0.0f, 1.0f) * m_bakedScale;
+		const uint32 index = (uint32)position;
+		const uint32 weight = (uint32)((position - (float)index) * 256.0f);
+
+		const uint32 left = m_bakedPacked[index];
+		const uint32 right = m_bakedPacked[index + 1];
+
+		// Two channels per multiplication, each 16-bit lane holds at most 255 * 256
+		const uint32 redBlue = ((left & 0x00FF00FF) * (256 - weight) + (right & 0x00FF00FF) * weight) >> 8;
+		const uint32 greenAlpha = ((left >> 8) & 0x00FF00FF) * (256 - weight) + ((right >> 8) & 0x00FF00FF) * weight;
+
+		return (redBlue & 0x00FF00FF) | (greenAlpha & 0xFF00FF00);
+	}
+
+	// Key frames may be modified through the returned reference, so the baked table is dropped
+	KeyFrame& GetKeyFrame(uint64 index)
+	{
+		m_baked.clear();
+		m_bakedPacked.clear();
+		return m_keyFrames[index];
+	}
+
+	std::vector<KeyFrame>& GetAllKeyFrames()
+	{
+		m_baked.clear();
+		m_bakedPacked.clear();
+		return m_keyFrames;
+	}
+
+	void ClearKeyFrames()
+	{
+		m_keyFrames.clear();
+		m_baked.clear();
+		m_bakedPacked.clear();
+	}
+
+	// Samples the curve into a table of the given resolution, Evaluate then becomes a single lookup.
+	// Tangents of key frames are only taken into account with Hermite interpolation
+	void Bake(uint32 resolution = 256, CurveInterpolation interpolation = CurveInterpolation::Linear)
+	{
+		GARBAGE_CORE_ASSERT(resolution > 1, "Curve can't be baked with resolution {}", resolution);
+
+		// One extra sample at the end lets the lookup read index + 1 without clamping
+		std::vector<ValueType> baked(resolution + 1);
+		for (uint32 i = 0; i < resolution; i++)
+		{
+			baked[i] = EvaluateKeyFrames((float)i / (float)(resolution - 1), interpolation);
+		}
+		baked[resolution] = baked[resolution - 1];
+
+		m_bakedPacked.resize(baked.size());
+		for (uint64 i = 0; i < baked.size(); i++) m_bakedPacked[i] = baked[i].GetAsPackedRGBA8();
+
+		m_baked = std::move(baked);
+		m_bakedScale = (float)(resolution - 1);
+		m_bakeResolution = resolution;
+		m_bakeInterpolation = interpolation;
+	}
+
+	// Modifying key frames drops the baked table. This bakes it again with the settings of the last Bake, or the defaults.
+	// Evaluation doesn't do it on demand, since curves are evaluated from several threads
+	void EnsureBaked()
+	{
+		if (m_baked.empty()) Bake(m_bakeResolution, m_bakeInterpolation);
+	}
+
+	bool IsBaked() const { return !m_baked.empty(); }
+
+private:
+
+	using ValueType = Color;
+
+	std::vector<KeyFrame> m_keyFrames;
+
+	std::vector<ValueType> m_baked;
+	std::vector<uint32> m_bakedPacked;
+	float m_bakedScale{ 0.0f };
+	uint32 m_bakeResolution{ 256 };
+	CurveInterpolation m_bakeInterpolation{ CurveInterpolation::Linear };
+
+	ValueType EvaluateKeyFrames(float time, CurveInterpolation interpolation) const
 	{
 		time = std::clamp(time, 0.0f, 1.0f);
 
@@ -177,11 +337,11 @@ public:
 		{
 			if (time == 1.0f) return m_keyFrames.back().Value;
 
-			for (uint32 i = 0; i < m_keyFrames.size(); i++)
+			for (uint64 i = 0; i + 1 < m_keyFrames.size(); i++)
 			{
 				if (m_keyFrames[i].Time <= time && m_keyFrames[i + 1].Time >= time)
 				{
-					return EvaluateBetween(time, m_keyFrames[i], m_keyFrames[i + 1]);
+					return EvaluateBetween(time, m_keyFrames[i], m_keyFrames[i + 1], interpolation);
 				}
 			}
 
@@ -197,44 +357,35 @@ public:
 		}
 	}
 
-	KeyFrame& GetKeyFrame(uint64 index)
+	Color EvaluateBaked(float time) const
 	{
-		return m_keyFrames[index];
-	}
+		const float position = std::clamp(time, 0.0f, 1.0f) * m_bakedScale;
+		const uint32 index = (uint32)position;
+		const float fraction = position - (float)index;
 
-	std::vector<KeyFrame>& GetAllKeyFrames()
-	{
-		return m_keyFrames;
-	}
+		const Color& left = m_baked[index];
+		const Color& right = m_baked[index + 1];
 
-	void ClearKeyFrames()
-	{
-		m_keyFrames.clear();
+		return Color(left.R + (right.R - left.R) * fraction, left.G + (right.G - left.G) * fraction,
+			left.B + (right.B - left.B) * fraction, left.A + (right.A - left.A) * fraction);
 	}
 
-private:
-
-	std::vector<KeyFrame> m_keyFrames;
-
-	Color EvaluateBetween(float t, const KeyFrame& left, const KeyFrame& right) const
+	Color EvaluateBetween(float t, const KeyFrame& left, const KeyFrame& right, CurveInterpolation interpolation) const
 	{
-		/*float dt = right.Time - left.Time;
-
-		float m0 = left.OutTangent * dt;
-		float m1 = right.InTangent * dt;
+		const float dt = right.Time - left.Time;
+		const float time = (t - left.Time) / dt;
 
-		float t2 = t * t;
-		float t3 = t2 * t;
+		if (interpolation == CurveInterpolation::Linear) return left.Value.Lerp(right.Value, time);
 
-		float a = 2.0f * t3 - 3.0f * t2 + 1.0f;
-		float b = t3 - 2.0f * t2 + t;
-		float c = t3 - t2;
-		float d = -2.0f * t3 + 3.0f * t2;
+		// A color has no single slope, so tangents shape the blend factor instead. Tangents of 1 give a linear blend
+		const float t2 = time * time;
+		const float t3 = t2 * time;
 
-		return a * left.Value + b * m0 + c * m1 + d * right.Value;*/
+		const float b = t3 - 2.0f * t2 + time;
+		const float c = t3 - t2;
+		const float d = -2.0f * t3 + 3.0f * t2;
 
-		const float time = (t - left.Time) / (right.Time - left.Time);
-		return left.Value.Lerp(right.Value, time);
+		return left.Value.Lerp(right.Value, b * left.OutTangent + c * right.InTangent + d);
 	}
 
 };
\ No newline at end of file
@@ -17,6 +17,8 @@ public:
 	static void Init(Ref<FileSystem> fileSystem);
 
 	static Ref<Asset> LoadAsset(const std::filesystem::path& name);
+	// Loads the assets in parallel on the job system, assets that can't be loaded are nullptr
+	static std::vector<Ref<Asset>> LoadAssets(const std::vector<std::filesystem::path>& names);
 	static void SaveAsset(Asset* asset, const std::filesystem::path& path);
 
 	static AssetType GetAssetType(const std::filesystem::path& name);
@@ -3,6 +3,7 @@
 #include "Core/Minimal.h"
 #include "Core/Asset/Asset.h"
 #include "Rendering/Texture.h"
+#include "Memory/Statistics.h"
 #include "Texture2D.generated.h"
 
 GCLASS();
@@ -12,8 +13,8 @@ class GARBAGE_API Texture2DAsset final : public Asset
 
 public:
 
-	Texture::Filtering MinFiltering;
-	Texture::Filtering MagFiltering;
+	Texture::Filtering MinFiltering{ Texture::Filtering::Linear };
+	Texture::Filtering MagFiltering{ Texture::Filtering::Linear };
 	Texture::WrapMode WrapMode;
 	bool GenerateMipmaps;
 
@@ -29,8 +30,11 @@ private:
 	Vector2 m_size;
 	uint8 m_numberOfColorChannels;
 	Ref<uint8[]> m_data;
+	TrackedMemory m_dataSize{ MemoryDomain::CPU, MemoryCategory::Assets };
 	Texture::Format m_format;
 
+	void SetData(uint8* data, uint64 size);
+
 };
 
 GCLASS(AssetType(Texture2DAsset), SourceFileFormats(png, jpg, tga, bmp, gif, pic, psd), ConvertedFormat(gbtex2d));
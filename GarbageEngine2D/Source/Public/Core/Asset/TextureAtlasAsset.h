@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Core/Minimal.h"
+#include "Core/Asset/Asset.h"
+#include "Rendering/Texture.h"
+#include "Memory/Statistics.h"
+#include "TextureAtlasAsset.generated.h"
+
+// Pixel rect of a packed texture inside its page, padding is not included
+struct GARBAGE_API TextureAtlasAssetRegion
+{
+	std::string Name;
+	uint16 Page{ 0 };
+	uint16 X{ 0 };
+	uint16 Y{ 0 };
+	uint16 Width{ 0 };
+	uint16 Height{ 0 };
+};
+
+GCLASS();
+class GARBAGE_API TextureAtlasAsset final : public Asset
+{
+	GENERATED_BODY()
+
+public:
+
+	// Same default as a texture specification and Texture2DAsset
+	Texture::Filtering Filtering{ Texture::Filtering::Linear };
+
+	uint16 GetPageSize() const { return m_pageSize; }
+	uint16 GetPadding() const { return m_padding; }
+
+	uint64 GetNumberOfPages() const { return m_pages.size(); }
+	// RGBA8 pixels, GetPageSize() x GetPageSize()
+	uint8* GetPageData(uint64 index) const { return m_pages[index].get(); }
+
+	const std::vector<TextureAtlasAssetRegion>& GetRegions() const { return m_regions; }
+
+private:
+
+	friend class TextureAtlasAssetFactory;
+
+	uint16 m_pageSize{ 2048 };
+	uint16 m_padding{ 1 };
+
+	std::vector<Ref<uint8[]>> m_pages;
+	std::vector<TextureAtlasAssetRegion> m_regions;
+	TrackedMemory m_pagesSize{ MemoryDomain::CPU, MemoryCategory::Assets };
+
+};
+
+// Source file is a text file with one texture asset path per line, lines starting with '#' are ignored.
+// Textures are packed into pages when the atlas is cooked, regions are named by the paths from the source file
+GCLASS(AssetType(TextureAtlasAsset), SourceFileFormats(atlas), ConvertedFormat(gbatlas));
+class GARBAGE_API TextureAtlasAssetFactory final : public AssetFactory
+{
+	GENERATED_BODY()
+
+public:
+
+	bool CreateFromSourceAsset(Asset* output, File* stream, std::string_view sourceFileExtension) override;
+	bool Serialize(Asset* asset, File* stream) override;
+	bool Deserialize(Asset* asset, File* stream) override;
+
+};
\ No newline at end of file
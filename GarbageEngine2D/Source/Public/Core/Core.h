@@ -6,5 +6,7 @@ namespace GarbageEngine2D
 {
 
 	GARBAGE_API void Init();
+	// Call while the window is still open, GPU resources are released with its context current
+	GARBAGE_API void Shutdown();
 
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Core/Base.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Number of unfinished jobs that were started with this counter
+class GARBAGE_API JobCounter
+{
+public:
+
+	JobCounter() = default;
+
+	bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+	uint32 GetValue() const { return m_value.load(std::memory_order_acquire); }
+
+	NON_COPYABLE(JobCounter)
+
+private:
+
+	friend class JobSystem;
+
+	std::atomic<uint32> m_value{ 0 };
+
+};
+
+// Runs jobs on a worker per hardware thread. Every worker has its own work-stealing deque,
+// idle workers steal jobs from the others. Jobs run inline until Init is called
+class GARBAGE_API JobSystem
+{
+public:
+
+	static constexpr uint64 MaxJobDataSize = 48;
+	static constexpr uint32 NotAWorker = 0xFFFFFFFF;
+
+	// 0 threads means one per hardware thread. The calling thread becomes worker 0 and runs jobs only while waiting
+	static void Init(uint32 numberOfThreads = 0);
+	static void Shutdown();
+	static bool IsInitialized();
+
+	// The function is stored inside the job, so its captures must fit into MaxJobDataSize bytes.
+	// The job doesn't start before the dependency is done, until then workers put it back to the shared queue
+	template <typename F>
+	static void Run(F&& function, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr)
+	{
+		using Function = std::decay_t<F>;
+
+		static_assert(sizeof(Function) <= MaxJobDataSize, "Job captures too much data, capture a pointer to it instead");
+		static_assert(alignof(Function) <= alignof(std::max_align_t), "Job function is over-aligned");
+
+		Job* job = AllocateJob();
+		new(job->Data) Function(std::forward<F>(function));
+
+		job->Execute = [](void* data)
+		{
+			Function& function = *(Function*)data;
+			function();
+			function.~Function();
+		};
+		job->Counter = counter;
+		job->Dependency = dependency;
+
+		if (counter) counter->m_value.fetch_add(1, std::memory_order_relaxed);
+
+		Submit(job);
+	}
+
+	// Executes other jobs while waiting
+	static void Wait(const JobCounter& counter);
+
+	// Calls function(index) for every index in [0, count) and waits for all of them, batchSize indices per job
+	template <typename F>
+	static void ParallelFor(uint64 count, uint64 batchSize, const F& function)
+	{
+		if (count == 0) return;
+
+		batchSize = std::max<uint64>(batchSize, 1);
+
+		JobCounter counter;
+
+		for (uint64 begin = 0; begin < count; begin += batchSize)
+		{
+			const uint64 end = std::min(begin + batchSize, count);
+
+			Run([&function, begin, end]()
+				{
+					for (uint64 i = begin; i < end; i++) function(i);
+				}, &counter);
+		}
+
+		Wait(counter);
+	}
+
+	static uint32 GetNumberOfThreads();
+	// Returns NotAWorker for threads that were not created by the job system
+	static uint32 GetCurrentThreadIndex();
+
+private:
+
+	struct Job
+	{
+		void (*Execute)(void* data);
+		JobCounter* Counter;
+		const JobCounter* Dependency;
+		std::atomic<bool> InUse{ false };
+		bool HeapAllocated{ false };
+
+		alignas(std::max_align_t) uint8 Data[MaxJobDataSize];
+	};
+
+	class WorkStealingQueue;
+	struct Worker;
+	struct Data;
+
+	static Data s_data;
+
+	static Job* AllocateJob();
+	static void Submit(Job* job);
+	static bool TryExecuteJob();
+	static bool DeferIfBlocked(Job* job);
+	static void Execute(Job* job);
+	static void WorkerMain(uint32 index);
+
+};
\ No newline at end of file
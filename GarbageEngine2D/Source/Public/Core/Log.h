@@ -16,11 +16,32 @@ class GARBAGE_API Log
 {
 public:
 
-	static void Init();
+	// What a logging thread does when the asynchronous queue is full
+	enum class OverflowPolicy
+	{
+		Block, Drop, Overwrite
+	};
+
+	struct Specification
+	{
+		// Asynchronous loggers only copy messages into a queue, a background thread writes them to the console
+		bool Asynchronous{ true };
+		uint32 QueueSize{ 8192 };
+		OverflowPolicy Overflow{ OverflowPolicy::Block };
+		uint32 FlushIntervalMilliseconds{ 500 };
+	};
+
+	static void Init() { Init(Specification()); }
+	static void Init(const Specification& specification);
+	// Writes all queued messages and stops the background thread
+	static void Shutdown();
 
 	static Ref<spdlog::logger> GetCoreLogger() { return s_coreLogger; }
 	static Ref<spdlog::logger> GetClientLogger();
 
+	// Messages lost because the queue was full with the Drop or Overwrite policy
+	static uint64 GetNumberOfDroppedMessages();
+
 private:
 
 	static Ref<spdlog::logger> s_coreLogger;
@@ -69,15 +90,40 @@ OStream& operator<<(OStream& os, const Color& color)
 	return os << "[R" << color.R << " G" << color.G << " B" << color.B << " A" << color.A << "]";
 }
 
-#define GARBAGE_CORE_DEBUG_(...) ::Log::GetCoreLogger()->debug(__VA_ARGS__)
+#define GARBAGE_LOG_LEVEL_TRACE 0
+#define GARBAGE_LOG_LEVEL_DEBUG 1
+#define GARBAGE_LOG_LEVEL_INFO 2
+
+// Messages below this level are removed at compile time together with their arguments
+#ifndef GARBAGE_LOG_LEVEL
+#ifdef GARBAGE_SHIPPING
+#define GARBAGE_LOG_LEVEL GARBAGE_LOG_LEVEL_INFO
+#else
+#define GARBAGE_LOG_LEVEL GARBAGE_LOG_LEVEL_TRACE
+#endif
+#endif
+
+#if GARBAGE_LOG_LEVEL <= GARBAGE_LOG_LEVEL_TRACE
 #define GARBAGE_CORE_TRACE(...) ::Log::GetCoreLogger()->trace(__VA_ARGS__)
+#define GARBAGE_TRACE(...) ::Log::GetClientLogger()->trace(__VA_ARGS__)
+#else
+#define GARBAGE_CORE_TRACE(...) ((void)0)
+#define GARBAGE_TRACE(...) ((void)0)
+#endif
+
+#if GARBAGE_LOG_LEVEL <= GARBAGE_LOG_LEVEL_DEBUG
+#define GARBAGE_CORE_DEBUG_(...) ::Log::GetCoreLogger()->debug(__VA_ARGS__)
+#define GARBAGE_DEBUG_(...) ::Log::GetClientLogger()->debug(__VA_ARGS__)
+#else
+#define GARBAGE_CORE_DEBUG_(...) ((void)0)
+#define GARBAGE_DEBUG_(...) ((void)0)
+#endif
+
 #define GARBAGE_CORE_INFO(...)  ::Log::GetCoreLogger()->info(__VA_ARGS__)
 #define GARBAGE_CORE_WARN(...)  ::Log::GetCoreLogger()->warn(__VA_ARGS__)
 #define GARBAGE_CORE_ERROR(...) ::Log::GetCoreLogger()->error(__VA_ARGS__)
 #define GARBAGE_CORE_FATAL(...) ::Log::GetCoreLogger()->critical(__VA_ARGS__)
 
-#define GARBAGE_DEBUG_(...) ::Log::GetClientLogger()->debug(__VA_ARGS__)
-#define GARBAGE_TRACE(...) ::Log::GetClientLogger()->trace(__VA_ARGS__)
 #define GARBAGE_INFO(...)  ::Log::GetClientLogger()->info(__VA_ARGS__)
 #define GARBAGE_WARN(...)  ::Log::GetClientLogger()->warn(__VA_ARGS__)
 #define GARBAGE_ERROR(...) ::Log::GetClientLogger()->error(__VA_ARGS__)
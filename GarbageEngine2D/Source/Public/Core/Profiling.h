@@ -1,42 +1,107 @@
 #pragma once
 
 #include "Core/Log.h"
+#include <atomic>
+#include <filesystem>
 
-class CoreProfiler
+#if !defined(GARBAGE_SHIPPING)
+#define GARBAGE_PROFILING_ENABLED 1
+#else
+#define GARBAGE_PROFILING_ENABLED 0
+#endif
+
+// Records scopes, counters and frame markers into per-thread ring buffers, captures can be exported
+// in the Chrome trace event format and opened in Perfetto or chrome://tracing
+class GARBAGE_API Profiler
 {
 public:
 
-	CoreProfiler(std::string_view functionSignature) : m_functionSignature(functionSignature) {}
+	// Must be a power of two, the oldest events of a thread are overwritten when its buffer is full
+	static constexpr uint32 EventsPerThread = 1 << 16;
+
+	enum class EventType : uint8
+	{
+		Begin, End, Counter, Frame
+	};
 
-	~CoreProfiler()
+	struct Event
 	{
-		GARBAGE_CORE_INFO("Function {} finished in {}ms", m_functionSignature, m_timer.GetElapsedMilliseconds());
+		// Names are not copied, they must outlive the capture
+		const char* Name;
+		// Nanoseconds since the profiler started
+		uint64 Timestamp;
+		int64 Value;
+		EventType Type;
+	};
+
+	static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+	static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+	// Shown instead of the thread index in the exported capture
+	static void SetThreadName(const char* name);
+
+	static void BeginScope(const char* name) { Record(EventType::Begin, name, 0); }
+	static void EndScope(const char* name) { Record(EventType::End, name, 0); }
+
+	static void Counter(const char* name, int64 value)
+	{
+		if (IsEnabled()) Record(EventType::Counter, name, value);
 	}
 
+	static void MarkFrame();
+
+	// Exports events recorded since the last Clear. Disable profiling first, events that are being written can't be exported reliably
+	static bool ExportChromeTrace(const std::filesystem::path& path);
+	static void Clear();
+
 private:
 
-	std::string_view m_functionSignature;
-	Timer m_timer;
+	static std::atomic<bool> s_enabled;
+
+	static void Record(EventType type, const char* name, int64 value);
 
 };
 
-class GARBAGE_API Profiler
+class ProfileScope
 {
 public:
 
-	Profiler(std::string_view functionSignature) : m_functionSignature(functionSignature) {}
+	ProfileScope(const char* name) : m_name(Profiler::IsEnabled() ? name : nullptr)
+	{
+		if (m_name) Profiler::BeginScope(m_name);
+	}
 
-	~Profiler()
+	// Scopes that began while profiling was enabled always end, so the capture stays balanced
+	~ProfileScope()
 	{
-		GARBAGE_INFO("Function {} finished in {}ms", m_functionSignature, m_timer.GetElapsedMilliseconds());
+		if (m_name) Profiler::EndScope(m_name);
 	}
 
+	NON_COPYABLE(ProfileScope)
+
 private:
 
-	std::string_view m_functionSignature;
-	Timer m_timer;
+	const char* m_name;
 
 };
 
-#define GARBAGE_CORE_PROFILE_FUNCTION() CoreProfiler __GARBAGE_FUNC_PROFILER(__FUNCTION__);
-#define GARBAGE_PROFILE_FUNCTION() Profiler __GARBAGE_FUNC_PROFILER(__FUNCTION__);
\ No newline at end of file
+#if GARBAGE_PROFILING_ENABLED
+
+#define GARBAGE_PROFILE_CONCATENATE_(a, b) a##b
+#define GARBAGE_PROFILE_CONCATENATE(a, b) GARBAGE_PROFILE_CONCATENATE_(a, b)
+
+#define GARBAGE_PROFILE_SCOPE(name) ProfileScope GARBAGE_PROFILE_CONCATENATE(__GARBAGE_SCOPE_PROFILER, __LINE__)(name)
+#define GARBAGE_PROFILE_COUNTER(name, value) Profiler::Counter(name, (int64)(value))
+#define GARBAGE_PROFILE_FRAME() Profiler::MarkFrame()
+
+#else
+
+#define GARBAGE_PROFILE_SCOPE(name)
+#define GARBAGE_PROFILE_COUNTER(name, value)
+#define GARBAGE_PROFILE_FRAME()
+
+#endif
+
+#define GARBAGE_CORE_PROFILE_SCOPE(name) GARBAGE_PROFILE_SCOPE(name)
+#define GARBAGE_CORE_PROFILE_FUNCTION() GARBAGE_PROFILE_SCOPE(__FUNCTION__)
+#define GARBAGE_PROFILE_FUNCTION() GARBAGE_PROFILE_SCOPE(__FUNCTION__)
\ No newline at end of file
@@ -3,8 +3,13 @@
 #include "Core/Base.h"
 #include "Core/Log.h"
 #include "Core/Archive.h"
+#include "Core/Assert.h"
+#include "Core/StringId.h"
 #include "Memory/Allocator.h"
-#include <functional>
+#include "Memory/PoolAllocator.h"
+#include "Memory/Statistics.h"
+#include <cstddef>
+#include <string_view>
 #include <type_traits>
 #include <optional>
 
@@ -50,13 +55,15 @@ namespace Meta
 		Enum& AddValue(const std::string& name, int64 value = UnknownValue);
 
 		// If nothing is found, returns Unknown
-		const std::string ValueToString(int64 value) const;
+		const std::string& ValueToString(int64 value) const;
 
-		std::optional<int64> StringToValue(const std::string& name) const;
+		std::optional<int64> StringToValue(std::string_view name) const { return StringToValue(StringId(name)); }
+		std::optional<int64> StringToValue(StringId id) const;
 
 		bool HasValue(int64 value) const { return m_values.find(value) != m_values.end(); }
 
-		bool HasValue(const std::string& name) const;
+		bool HasValue(std::string_view name) const { return HasValue(StringId(name)); }
+		bool HasValue(StringId id) const { return m_indices.find(id) != m_indices.end(); }
 
 		const std::string& GetName() const { return m_name; }
 		const std::unordered_map<int64, std::string>& GetValues() const { return m_values; }
@@ -69,116 +76,370 @@ namespace Meta
 		std::string m_name;
 
 		ValuesMap m_values;
+		// Reverse index, also keeps aliases of values that were renamed
+		std::unordered_map<StringId, int64> m_indices;
+
+		int64 m_lastValue{ -1 };
 
 	};
 
+	// Read-only view of contiguous elements, e.g. of a reflection table
+	template <typename T>
+	class ArrayView
+	{
+	public:
+
+		constexpr ArrayView() = default;
+		constexpr ArrayView(const T* data, uint64 size) : m_data(data), m_size(size) {}
+		ArrayView(const std::vector<T>& elements) : m_data(elements.data()), m_size(elements.size()) {}
+
+		const T* begin() const { return m_data; }
+		const T* end() const { return m_data + m_size; }
+
+		const T& operator[](uint64 index) const { return m_data[index]; }
+
+		uint64 GetSize() const { return m_size; }
+		bool IsEmpty() const { return m_size == 0; }
+
+	private:
+
+		const T* m_data{ nullptr };
+		uint64 m_size{ 0 };
+
+	};
+
+	// Decorators as passed to the step by step registration, the registry keeps them as descriptors
 	struct GARBAGE_API Decorator final
 	{
 		std::string Name;
 		std::vector<std::string> Values;
+		// Generated code passes it precomputed, otherwise it is interned from Name on registration
+		StringId Id;
+	};
+
+	// Read-only reflection data, emitted by GarbageHeaderTool so registering a module doesn't run per type code.
+	// Registered types point into these tables instead of copying them
+	struct DecoratorDescriptor
+	{
+		const char* Name;
+		const char* const* Values;
+		uint32 NumberOfValues;
+		StringId Id;
+	};
+
+	using DecoratorValues = ArrayView<const char*>;
+	using Serializer = void (*)(Archive& archive, ObjectBase* object);
+
+	// Backs the descriptors of decorators that were registered step by step, strings are interned
+	struct DecoratorStorage
+	{
+		std::vector<const char*> Values;
+		std::vector<DecoratorDescriptor> Decorators;
+
+		ArrayView<DecoratorDescriptor> Store(std::initializer_list<Decorator> decorators);
+	};
+
+	// Decorators are a handful per type or property, comparing the ids is cheaper than a table
+	inline const DecoratorDescriptor* FindDecorator(ArrayView<DecoratorDescriptor> decorators, StringId id)
+	{
+		for (auto& decorator : decorators)
+		{
+			if (decorator.Id == id) return &decorator;
+		}
+
+		return nullptr;
+	}
+
+	// What a property holds, so generic code can read it without knowing the C++ type
+	enum class PropertyKind : uint8
+	{
+		Unknown,
+		Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64,
+		Bool, Float, Double,
+		Vector2, Vector3, Vector4, Color, Quaternion,
+		String
+	};
+
+	// Primitives and math types are plain data and can be copied with memcpy
+	constexpr bool IsTrivialKind(PropertyKind kind) { return kind != PropertyKind::Unknown && kind != PropertyKind::String; }
+
+	template <typename T>
+	constexpr PropertyKind GetPropertyKind()
+	{
+		if constexpr (std::is_enum_v<T>) return GetPropertyKind<std::underlying_type_t<T>>();
+		else if constexpr (std::is_same_v<T, bool>) return PropertyKind::Bool;
+		else if constexpr (std::is_integral_v<T>)
+		{
+			// By size, so int, long and the engine typedefs map to the same kinds on every platform
+			constexpr bool isSigned = std::is_signed_v<T>;
+
+			if constexpr (sizeof(T) == 1) return isSigned ? PropertyKind::Int8 : PropertyKind::UInt8;
+			else if constexpr (sizeof(T) == 2) return isSigned ? PropertyKind::Int16 : PropertyKind::UInt16;
+			else if constexpr (sizeof(T) == 4) return isSigned ? PropertyKind::Int32 : PropertyKind::UInt32;
+			else return isSigned ? PropertyKind::Int64 : PropertyKind::UInt64;
+		}
+		else if constexpr (std::is_same_v<T, float>) return PropertyKind::Float;
+		else if constexpr (std::is_same_v<T, double>) return PropertyKind::Double;
+		else if constexpr (std::is_same_v<T, ::Vector2>) return PropertyKind::Vector2;
+		else if constexpr (std::is_same_v<T, ::Vector3>) return PropertyKind::Vector3;
+		else if constexpr (std::is_same_v<T, ::Vector4>) return PropertyKind::Vector4;
+		else if constexpr (std::is_same_v<T, ::Color>) return PropertyKind::Color;
+		else if constexpr (std::is_same_v<T, ::Quaternion>) return PropertyKind::Quaternion;
+		else if constexpr (std::is_same_v<T, std::string>) return PropertyKind::String;
+		else return PropertyKind::Unknown;
+	}
+
+	struct PropertyLayout
+	{
+		// From the start of the object, which is where its ObjectBase is
+		uint32 Offset;
+		uint32 Size;
+		uint32 Alignment;
+		PropertyKind Kind;
+	};
+
+	// GarbageHeaderTool passes offsetof of the member
+	template <typename U>
+	constexpr PropertyLayout MakePropertyLayout(uint64 offset)
+	{
+		return { (uint32)offset, (uint32)sizeof(U), (uint32)alignof(U), GetPropertyKind<U>() };
+	}
+
+	// For hand written registration, offsetof doesn't take member pointers.
+	// The member pointer is applied to storage that is really there and aligned for T, no object is constructed or read
+	template <typename T, typename U>
+	PropertyLayout GetPropertyLayout(U T::* member)
+	{
+		alignas(T) uint8 storage[sizeof(T)];
+		const T* object = reinterpret_cast<const T*>(storage);
+
+		return MakePropertyLayout<U>((uint64)(reinterpret_cast<const uint8*>(&(object->*member)) - storage));
+	}
+
+	struct PropertySpan
+	{
+		uint32 Offset;
+		uint32 Size;
 	};
 
 	struct GARBAGE_API Property final
 	{
-		std::string Name;
-		std::string Type;
-		void* ObjectBase::* Pointer;
-		std::vector<Decorator> Decorators;
+		std::string_view Name;
+		std::string_view Type;
+		PropertyLayout Layout;
+		ArrayView<DecoratorDescriptor> Decorators;
+		StringId Id;
+
+		void* GetAddress(ObjectBase* obj) const { return (uint8*)obj + Layout.Offset; }
+		const void* GetAddress(const ObjectBase* obj) const { return (const uint8*)obj + Layout.Offset; }
 
 		template <typename T>
-		T Get(ObjectBase* obj) const { return obj->*(T ObjectBase::*)(Pointer); }
+		T Get(ObjectBase* obj) const
+		{
+			GARBAGE_CORE_ASSERT(sizeof(T) == Layout.Size, "Property {} read as a type of another size", Name);
+			return *(T*)GetAddress(obj);
+		}
 
 		template <typename T>
-		void Set(ObjectBase* obj, T value) { obj->*(T ObjectBase::*)(Pointer) = value; }
+		void Set(ObjectBase* obj, T value)
+		{
+			GARBAGE_CORE_ASSERT(sizeof(T) == Layout.Size, "Property {} written as a type of another size", Name);
+			*(T*)GetAddress(obj) = value;
+		}
+
+		bool HasDecorator(std::string_view name) const { return HasDecorator(StringId(name)); }
+		bool HasDecorator(StringId id) const { return FindDecorator(Decorators, id) != nullptr; }
+
+		// Empty if there is no such decorator
+		DecoratorValues GetDecoratorValues(std::string_view name) const { return GetDecoratorValues(StringId(name)); }
+		DecoratorValues GetDecoratorValues(StringId id) const;
+
+	};
+
+	// The factory of a type. Not a member of the exported Type, so its address stays a constant expression
+	// in generated reflection tables of other modules
+	template <typename T, typename... Args>
+	ObjectBase* Instantiate(Allocator* allocator, Args&&... args)
+	{
+		if (allocator)
+		{
+			auto obj = (T*)GARBAGE_TAGGED_ALLOCATE(allocator, sizeof(T), alignof(T));
+
+			new(obj) T(std::forward<Args>(args)...);
+
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				allocator->RegisterDestructor(obj, [](void* object) { ((T*)object)->~T(); });
+			}
+
+			return (ObjectBase*)obj;
+		}
+
+		return (ObjectBase*)(void*)(new T(std::forward<Args>(args)...));
+	}
+
+	struct PropertyDescriptor
+	{
+		const char* Name;
+		const char* Type;
+		PropertyLayout (*GetLayout)();
+		const DecoratorDescriptor* Decorators;
+		uint32 NumberOfDecorators;
+		StringId Id;
+	};
+
+	struct TypeDescriptor
+	{
+		const char* Name;
+		ObjectBase* (*Factory)(Allocator* allocator);
+		void (*Serializer)(Archive& archive, ObjectBase* object);
+		uint64 Size;
+		uint64 Alignment;
+		const char* const* Parents;
+		uint32 NumberOfParents;
+		const PropertyDescriptor* Properties;
+		uint32 NumberOfProperties;
+		const DecoratorDescriptor* Decorators;
+		uint32 NumberOfDecorators;
+	};
 
-		bool HasDecorator(std::string_view name) const;
-		const std::vector<std::string>* GetDecoratorValues(std::string_view name) const;
+	struct EnumValueDescriptor
+	{
+		const char* Name;
+		int64 Value;
+	};
 
+	struct EnumDescriptor
+	{
+		const char* Name;
+		const EnumValueDescriptor* Values;
+		uint32 NumberOfValues;
 	};
 
 	class GARBAGE_API Type final
 	{
 	public:
 
-		Type() = default;
-
-		Type(const std::string& name) : m_name(name) {}
+		Type() { MemoryStatistics::Allocated(MemoryDomain::CPU, MemoryCategory::Reflection, sizeof(Type)); }
 		~Type();
 
 		ObjectBase* Construct(Allocator* allocator) const { return m_factory(allocator); }
+		// Uses the allocator bound to the type, or the heap if there is none
+		ObjectBase* Construct() const { return m_factory(m_allocator); }
+
+		// Destroys an object of exactly this type that was created with Construct()
+		void Destroy(ObjectBase* object) const;
 
 		Type& AddParent(const Type* parent);
 		Type& AddChild(const Type* child);
 
-		bool HasParent(const std::string& parent) const;
+		bool HasParent(std::string_view parent) const;
 		bool HasParent(const Type* parent) const;
 
-		bool HasChild(const std::string& child) const;
+		bool HasChild(std::string_view child) const;
 		bool HasChild(const Type* child) const;
 
+		// True for the type itself and all of its descendants. Two integer comparisons once the registry is frozen
+		bool IsDerivedFrom(const Type* base) const
+		{
+			if (m_preorder == 0 || base->m_preorder == 0) return this == base || HasParent(base);
+			if (base->m_preorder <= m_preorder && m_preorder <= base->m_lastDescendant) return true;
+
+			return base->m_id < m_ancestors.size() * 64 && ((m_ancestors[base->m_id / 64] >> (base->m_id % 64)) & 1);
+		}
+
 		template <typename T, typename U>
-		Type& AddProperty(const std::string& name, const std::string& type, U T::* ptr, std::initializer_list<Decorator> decorators = {})
+		Type& AddProperty(std::string_view name, std::string_view type, U T::* ptr, std::initializer_list<Decorator> decorators = {})
 		{
-			auto prop = new Property{ name, type, (void* ObjectBase::*)(void* T::*)ptr, decorators };
-			m_properties.push_back(prop);
-			return *this;
+			return AddProperty(name, type, GetPropertyLayout(ptr), decorators);
 		}
 
-		Property* FindProperty(const std::string& name) const;
+		// Names and decorators are interned, so they outlive the arguments like the strings of reflection tables do
+		Type& AddProperty(std::string_view name, std::string_view type, const PropertyLayout& layout, std::initializer_list<Decorator> decorators = {});
+
+		// Searches the type, then its parents in order. A hash lookup once the registry is frozen
+		Property* FindProperty(std::string_view name) const { return FindProperty(StringId(name)); }
+		Property* FindProperty(StringId id) const;
 
 		inline const std::vector<Property*>& GetProperties() const { return m_properties; }
 		inline const std::vector<const Type*>& GetParents() const { return m_parents; }
 		inline const std::vector<const Type*>& GetChildren() const { return m_children; }
-		inline const std::string& GetName() const { return m_name; }
+		inline std::string_view GetName() const { return m_name; }
 		inline uint32 GetId() const { return m_id; }
+		inline uint64 GetSize() const { return m_size; }
+		inline uint64 GetAlignment() const { return m_alignment; }
+		inline Allocator* GetAllocator() const { return m_allocator; }
 
 		bool IsStruct() const { return m_parents.size() == 0 && m_children.size() == 0; }
 
-		bool HasDecorator(std::string_view name) const;
-		const std::vector<std::string>* GetDecoratorValues(std::string_view name) const;
+		bool HasDecorator(std::string_view name) const { return HasDecorator(StringId(name)); }
+		bool HasDecorator(StringId id) const { return FindDecorator(m_decorators, id) != nullptr; }
+
+		// Empty if there is no such decorator
+		DecoratorValues GetDecoratorValues(std::string_view name) const { return GetDecoratorValues(StringId(name)); }
+		DecoratorValues GetDecoratorValues(StringId id) const;
 
 		void Serialize(Archive& archive, ObjectBase* object) const;
 
+		// Byte ranges of own and inherited properties of trivial kinds, sorted and merged where they touch.
+		// Filled when the registry is frozen
+		inline const std::vector<PropertySpan>& GetTrivialSpans() const { return m_trivialSpans; }
+		uint64 GetTrivialSize() const;
+
+		// Copy the trivial properties with one memcpy per span. Objects have to be of this type or derived from it
+		void CopyTrivialProperties(ObjectBase* destination, const ObjectBase* source) const;
+		// Packs them into a buffer of GetTrivialSize() bytes and back, for binary serialization
+		void ReadTrivialProperties(const ObjectBase* object, void* buffer) const;
+		void WriteTrivialProperties(ObjectBase* object, const void* buffer) const;
+
 	private:
 
 		friend Registry;
 
-		std::string m_name;
+		// Points into a reflection table, or to an interned string
+		std::string_view m_name;
 		ObjectBase* (*m_factory)(Allocator* allocator) = nullptr;
 
 		std::vector<const Type*> m_parents;
 		std::vector<const Type*> m_children;
+		// Properties from reflection tables are owned by the registry, the rest by m_ownedProperties
 		std::vector<Property*> m_properties;
-		std::vector<Decorator> m_decorators;
+		ArrayView<DecoratorDescriptor> m_decorators;
+
+		// Only used by the step by step registration
+		struct OwnedProperty
+		{
+			Property Value;
+			DecoratorStorage Decorators;
+		};
+
+		std::vector<Scope<OwnedProperty>> m_ownedProperties;
+		Scope<DecoratorStorage> m_ownedDecorators;
+
+		// Own and inherited properties, filled when the registry is frozen
+		std::unordered_map<StringId, Property*> m_propertyTable;
+		std::vector<PropertySpan> m_trivialSpans;
 
 		uint32 m_id{ 0 };
 
-		std::function<void(Archive&, ObjectBase*)> m_serializer;
+		// Preorder index in the tree formed by the first parent of every type, 0 until the registry is frozen.
+		// Descendants in that tree have preorder indices in [m_preorder, m_lastDescendant]
+		uint32 m_preorder{ 0 };
+		uint32 m_lastDescendant{ 0 };
+		// Bitset of ancestor ids, only for types inheriting from more than one reflected type somewhere up the hierarchy
+		std::vector<uint64> m_ancestors;
 
-		template <typename T, typename... Args>
-		static Scope<Type> Create(const std::string& name, uint32 id, std::function<void(Archive&, ObjectBase*)> serializer = {}, std::initializer_list<Decorator> decorators = {})
-		{
-			Scope<Type> type = MakeScope<Type>(name);
-			type->m_factory = [](Allocator* allocator, Args&&... args) -> ObjectBase* 
-			{
-				/*return (ObjectBase*)(void*)(new T(std::forward<Args>(args)...)); */
-
-				if (allocator)
-				{
-					auto obj = (T*)allocator->Allocate(sizeof(T));
-
-					new(obj) T(std::forward<Args>(args)...);
-					return (ObjectBase*)obj;
-				}
-				
-				return (ObjectBase*)(void*)(new T(std::forward<Args>(args)...));
-			};
-			type->m_id = id;
-			type->m_decorators = decorators;
-			type->m_serializer = serializer;
-
-			return std::move(type);
-		}
+		uint64 m_size{ 0 };
+		uint64 m_alignment{ 0 };
+
+		Allocator* m_allocator{ nullptr };
+
+		Serializer m_serializer{ nullptr };
+
+		void CollectTrivialSpans(std::vector<PropertySpan>& spans) const;
+		// The spans of the frozen registry, or collected into the given vector
+		const std::vector<PropertySpan>& GetSpans(std::vector<PropertySpan>& collected) const;
+		void SetDecorators(std::initializer_list<Decorator> decorators);
 
 	};
 
@@ -189,38 +450,76 @@ namespace Meta
 		static Registry& Get();
 
 		template <typename T, typename... Args>
-		Type& AddType(const std::string& name, std::function<void(Archive&, ObjectBase*)> serializer = {}, std::initializer_list<Decorator> decorators = {})
+		Type& AddType(std::string_view name, Serializer serializer = nullptr, std::initializer_list<Decorator> decorators = {})
 		{
-			m_types[name] = Type::Create<T, Args...>(name, m_lastClassId++, serializer, decorators);
-
-			return *m_types[name];
+			Type& type = CreateType(name);
+			type.m_factory = &Instantiate<T, Args...>;
+			type.m_size = sizeof(T);
+			type.m_alignment = alignof(T);
+			type.m_serializer = serializer;
+			type.SetDecorators(decorators);
+
+			return type;
 		}
 
-		const Type* FindType(const std::string& name) const;
+		const Type* FindType(std::string_view name) const;
 
 		Enum& AddEnum(const std::string& name);
 
 		const Enum* FindEnum(const std::string& name) const;
 
+		// Register tables terminated by an entry without a name. Parents are looked up by name,
+		// so they can be in the same table or in a module registered before. The tables must outlive the registry
+		void AddTypes(const TypeDescriptor* types);
+		void AddEnums(const EnumDescriptor* enums);
+
 		std::vector<const Type*> GetAllTypes() const;
 
+		// Precomputes the type hierarchy for Type::IsDerivedFrom and the inherited property tables,
+		// called after all types of a module are registered.
+		// Types added or reparented later fall back to walking the hierarchy until the next freeze
+		void Freeze();
+
+		// Creates a pool for objects of the type, Construct() and Destroy() of the type will use it
+		PoolAllocator& BindPool(const Type* type, const PoolAllocator::Specification& specification = PoolAllocator::Specification());
+
 		Registry(const Registry&) = delete;
 		Registry& operator=(const Registry&) = delete;
 
 	private:
 
+		friend Type;
+
 		Registry()
 		{
 			AddType<ObjectBase>("ObjectBase");
 		}
 
-		~Registry() = default;
+		~Registry();
+
+		// A type of the step by step registration, with an interned name
+		Type& CreateType(std::string_view name);
+
+		// Returns the last preorder index used in the subtree of the type
+		static uint32 AssignPreorder(Type* type, uint32 counter);
+		static void FlattenProperties(Type* type);
+
+		// Drops everything computed by Freeze(), lookups fall back to walking the hierarchy
+		void Unfreeze();
 
 		uint32 m_lastClassId = 1;
 
-		std::unordered_map<std::string, Scope<Type>> m_types;
+		// Types and properties registered from tables, one block of each per table.
+		// Step by step registration adds a block for every type
+		std::vector<Scope<Type[]>> m_typeBlocks;
+		std::vector<std::vector<Property>> m_tableProperties;
+
+		// Keys view the names of the types
+		std::unordered_map<std::string_view, Type*> m_types;
 		std::unordered_map<std::string, Scope<Enum>> m_enums;
 
+		std::unordered_map<const Type*, Scope<PoolAllocator>> m_pools;
+
 	};
 
 }
@@ -230,7 +529,7 @@ inline bool ObjectBase::IsA() const
 {
 	if constexpr(std::is_base_of<ObjectBase, T>::value)
 	{
-		return T::GetStaticType() == GetType() || GetType()->HasChild(T::GetStaticType()) || GetType()->HasParent(T::GetStaticType());
+		return GetType()->IsDerivedFrom(T::GetStaticType());
 	}
 	else
 	{
@@ -243,7 +542,7 @@ inline T* SlowCast(U* object)
 {
 	if constexpr (std::is_base_of<ObjectBase, T>::value && std::is_base_of<ObjectBase, U>::value)
 	{
-		return (object && (object->GetType()->HasParent(T::GetType()) || object->GetType()->HasChild(T::GetType()))) ? (T*)object : nullptr;
+		return (object && object->GetType()->IsDerivedFrom(T::GetStaticType())) ? (T*)object : nullptr;
 	}
 	else
 	{
@@ -3,6 +3,7 @@
 #include "Core/Base.h"
 #include "Core/Registry.h"
 #include "Math/Vector3.h"
+#include "Math/Transform2D.h"
 #include "SceneComponent.generated.h"
 
 GCLASS();
@@ -19,6 +20,9 @@ public:
 	GPROPERTY();
 	Vector3 Scale;
 
+	// Uses X and Y of location and scale and rotation around Z, which is in degrees
+	Transform2D GetTransform2D() const { return Transform2D(Vector2(Location.X, Location.Y), Rotation.Z * Math::Deg2Rad, Vector2(Scale.X, Scale.Y)); }
+
 };
 
 GCLASS();
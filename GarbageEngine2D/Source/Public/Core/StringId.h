@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Core/Base.h"
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Hashed name, compares as a single integer. Constructible at compile time, so generated code and
+// hot lookups never build std::string temporaries
+class GARBAGE_API StringId
+{
+public:
+
+	constexpr StringId() = default;
+	constexpr explicit StringId(uint64 hash) : m_hash(hash) {}
+	constexpr explicit StringId(std::string_view string) : m_hash(Hash(string)) {}
+
+	// 64-bit FNV-1a
+	static constexpr uint64 Hash(std::string_view string)
+	{
+		uint64 hash = 14695981039346656037ull;
+
+		for (char c : string)
+		{
+			hash ^= (uint64)(uint8)c;
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	// Hashes the string and remembers it so GetString() can give it back, asserts on hash collisions
+	static StringId Intern(std::string_view string);
+
+	// Empty if the id was never interned
+	const std::string& GetString() const;
+
+	constexpr uint64 GetHash() const { return m_hash; }
+	constexpr bool IsValid() const { return m_hash != 0; }
+
+	constexpr bool operator==(StringId other) const { return m_hash == other.m_hash; }
+	constexpr bool operator!=(StringId other) const { return m_hash != other.m_hash; }
+
+private:
+
+	uint64 m_hash{ 0 };
+
+};
+
+namespace std
+{
+
+	template <>
+	struct hash<StringId>
+	{
+		// FNV-1a is already well distributed
+		size_t operator()(StringId id) const { return (size_t)id.GetHash(); }
+	};
+
+}
+
+// Forces the hash to be computed at compile time
+#define GARBAGE_SID(string) StringId(std::integral_constant<uint64, StringId::Hash(string)>::value)
\ No newline at end of file
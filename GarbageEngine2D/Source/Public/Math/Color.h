@@ -35,6 +35,8 @@ public:
 	Vector2 GetAsVector2() const;
 	Vector3 GetAsVector3() const;
 	Vector4 GetAsVector4() const;
+	// Clamped to [0, 1] and packed with R in the lowest byte, the memory layout matches GL_RGBA + GL_UNSIGNED_BYTE
+	uint32 GetAsPackedRGBA8() const;
 
 	Color Lerp(const Color & other, float time) const;
 	static Color Lerp(const Color & left, const Color & right, float time);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Core/Base.h"
+
+// IEEE 754 half precision float, used only as a storage format for GPU data
+class GARBAGE_API Half final
+{
+public:
+
+	uint16 Bits{ 0 };
+
+	Half() = default;
+	explicit Half(float value);
+
+	explicit operator float() const;
+
+};
\ No newline at end of file
@@ -119,3 +119,6 @@ GARBAGE_API inline Matrix4 operator*(float f, const Matrix4& m)
 {
     return (m * f);
 }
+
+// Writes matrix * (x, y, 0, 1) for every point, uses AVX2 when the CPU supports it
+GARBAGE_API void TransformPoints(const Matrix4& matrix, const Vector2* in, Vector4* out, uint64 count);
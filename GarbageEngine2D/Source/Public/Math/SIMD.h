@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Core/Base.h"
+
+// SSE2 is a part of x86-64, so it is always used on supported platforms. AVX2 code is compiled
+// for every build and selected at runtime, see SIMD::IsAVX2Supported
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define GARBAGE_SIMD_SSE2 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#else
+#define GARBAGE_SIMD_SSE2 0
+#endif
+
+#if GARBAGE_SIMD_SSE2 && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+#define GARBAGE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GARBAGE_TARGET_AVX2
+#endif
+
+#define GARBAGE_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+
+namespace SIMD
+{
+
+	// Checks both CPU and OS support, the result is cached after the first call
+	GARBAGE_API bool IsAVX2Supported();
+
+}
\ No newline at end of file
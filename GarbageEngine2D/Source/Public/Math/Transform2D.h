@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Math/Vector2.h"
+
+class Matrix4;
+
+// 2D affine transform stored as a 2x3 matrix with columns AxisX, AxisY and Translation
+class GARBAGE_API GARBAGE_ALIGN(8) Transform2D final
+{
+public:
+
+	static const Transform2D Identity;
+
+	Vector2 AxisX;
+	Vector2 AxisY;
+	Vector2 Translation;
+
+	Transform2D() : AxisX(1.0f, 0.0f), AxisY(0.0f, 1.0f), Translation(0.0f, 0.0f) {}
+	Transform2D(const Vector2& axisX, const Vector2& axisY, const Vector2& translation) : AxisX(axisX), AxisY(axisY), Translation(translation) {}
+	// Rotation is in radians, scale is applied first, then rotation, then translation
+	Transform2D(const Vector2& position, float rotation, const Vector2& scale = Vector2(1.0f, 1.0f));
+
+	// Keeps only X and Y axes and translation of the matrix
+	static Transform2D FromMatrix4(const Matrix4& matrix);
+	Matrix4 ToMatrix4() const;
+
+	// Result applies other first and then this
+	Transform2D operator*(const Transform2D& other) const;
+	Transform2D& operator*=(const Transform2D& other);
+
+	bool operator==(const Transform2D& other) const;
+
+	FORCEINLINE Vector2 TransformPoint(const Vector2& point) const
+	{
+		return Vector2(AxisX.X * point.X + AxisY.X * point.Y + Translation.X, AxisX.Y * point.X + AxisY.Y * point.Y + Translation.Y);
+	}
+
+	FORCEINLINE Vector2 TransformVector(const Vector2& vector) const
+	{
+		return Vector2(AxisX.X * vector.X + AxisY.X * vector.Y, AxisX.Y * vector.X + AxisY.Y * vector.Y);
+	}
+
+	// In and out may point to the same memory
+	void TransformPoints(const Vector2* in, Vector2* out, uint64 count) const;
+
+	float GetDeterminant() const { return AxisX.X * AxisY.Y - AxisY.X * AxisX.Y; }
+	Transform2D Inverse() const;
+
+	Vector2 GetPosition() const { return Translation; }
+	float GetRotation() const;
+	Vector2 GetScale() const;
+
+};
\ No newline at end of file
@@ -1,15 +1,24 @@
 #pragma once
 
 #include "Core/Base.h"
+#include <cstddef>
 
 class GARBAGE_API Allocator
 {
 public:
 
+	using Destructor = void(*)(void* object);
+
 	Allocator(uint64 reserved = 1024) {}
 	virtual ~Allocator() = default;
 
-	virtual void* Allocate(uint64 size) = 0;
+	virtual void* Allocate(uint64 size, uint64 alignment = alignof(std::max_align_t)) = 0;
+	// Allocators that release memory all at once ignore it
+	virtual void Deallocate(void* pointer, uint64 size, uint64 alignment = alignof(std::max_align_t)) {}
+
+	// The destructor is called when the memory of the object is released by the allocator.
+	// Allocators that never release memory of separate objects ignore it
+	virtual void RegisterDestructor(void* object, Destructor destructor) {}
 
 	virtual uint64 Current() const = 0;
 	virtual uint64 Length() const = 0;
@@ -1,16 +1,45 @@
 #pragma once
 
 #include "Memory/Allocator.h"
+#include "Memory/Statistics.h"
+#include <type_traits>
+#include <utility>
 
+// Allocates from a list of fixed-size chunks. Chunks are never moved, so pointers stay valid until the arena is rewound
 class GARBAGE_API ArenaAllocator final : public Allocator
 {
 public:
 
-	ArenaAllocator(uint64 size = 1024);
+	struct Marker
+	{
+		void* Chunk{ nullptr };
+		uint64 ChunkUsed{ 0 };
+		void* Destructors{ nullptr };
+		uint64 Length{ 0 };
+		uint64 RetiredBytes{ 0 };
+	};
+
+	ArenaAllocator(uint64 chunkSize = 4096);
 
 	~ArenaAllocator();
 
-	void* Allocate(uint64 size) override;
+	void* Allocate(uint64 size, uint64 alignment = alignof(std::max_align_t)) override;
+
+	template <typename T, typename... Args>
+	T* New(Args&&... args)
+	{
+		T* object = new(GARBAGE_TAGGED_ALLOCATE(this, sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			RegisterDestructor(object, [](void* pointer) { ((T*)pointer)->~T(); });
+		}
+
+		return object;
+	}
+
+	// Destructors are called in reverse order of registration on rewind and reset
+	void RegisterDestructor(void* object, Destructor destructor) override;
 
 	uint64 Current() const override;
 
@@ -18,12 +47,56 @@ public:
 
 	void Reserve(uint64 size) override;
 
+	Marker GetMarker() const;
+	// Releases everything that was allocated after the marker was taken
+	void RewindTo(const Marker& marker);
+
 	void Reset();
 
+	uint64 GetChunkSize() const { return m_chunkSize; }
+	uint64 GetNumberOfChunks() const { return m_numberOfChunks; }
+	// Highest number of bytes taken from chunks, including padding and unused chunk tails
+	uint64 GetPeakBytes() const { return m_peakBytes; }
+	// Bytes currently lost to alignment padding and to tails of chunks that could not fit an allocation
+	uint64 GetWastedBytes() const;
+
+	NON_COPYABLE(ArenaAllocator)
+
 private:
 
-	void* m_bytes{ nullptr };
-	uint64 m_bytesWritten{ 0 };
-	uint64 m_capacity{ 0 };
+	struct Chunk
+	{
+		Chunk* Previous;
+		uint64 Size;
+		uint64 Used;
+	};
+
+	struct DestructorNode
+	{
+		DestructorNode* Previous;
+		void* Object;
+		Destructor Function;
+	};
+
+	uint64 m_chunkSize;
+
+	Chunk* m_firstChunk{ nullptr };
+	Chunk* m_currentChunk{ nullptr };
+	// Rewound chunks of the default size are kept for reuse
+	Chunk* m_freeChunks{ nullptr };
+	uint64 m_numberOfChunks{ 0 };
+
+	DestructorNode* m_destructors{ nullptr };
+
+	uint64 m_length{ 0 };
+	// Sizes of chunks before the current one
+	uint64 m_retiredBytes{ 0 };
+	uint64 m_peakBytes{ 0 };
+
+	static uint8* GetChunkData(Chunk* chunk) { return (uint8*)(chunk + 1); }
+
+	Chunk* CreateChunk(uint64 size);
+	void AddChunk(uint64 minimumSize);
+	void ReleaseChunk(Chunk* chunk);
 
 };
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Memory/ArenaAllocator.h"
+#include "Memory/StlAllocator.h"
+#include <string>
+#include <vector>
+
+// Linear allocator for data that lives for a few frames. Every frame gets its own arena,
+// which is reset only when the frame comes around again, so data can be used until the GPU is done with it.
+// Not thread-safe, allocate from the thread that flips the frames
+class GARBAGE_API FrameAllocator final : public Allocator
+{
+public:
+
+	FrameAllocator(uint32 numberOfFrames = 3, uint64 chunkSize = 64 * 1024);
+
+	void* Allocate(uint64 size, uint64 alignment = alignof(std::max_align_t)) override;
+
+	template <typename T, typename... Args>
+	T* New(Args&&... args)
+	{
+		return m_frames[m_currentFrame]->New<T>(std::forward<Args>(args)...);
+	}
+
+	// Destructors are called when the frame is reused
+	void RegisterDestructor(void* object, Destructor destructor) override;
+
+	uint64 Current() const override;
+
+	uint64 Length() const override;
+
+	void Reserve(uint64 size) override;
+
+	// Moves to the next frame and releases everything that was allocated in it numberOfFrames frames ago
+	void NextFrame();
+
+	uint32 GetNumberOfFrames() const { return (uint32)m_frames.size(); }
+	uint32 GetCurrentFrame() const { return m_currentFrame; }
+	const ArenaAllocator& GetFrameArena(uint32 frame) const { return *m_frames[frame]; }
+
+	NON_COPYABLE(FrameAllocator)
+
+private:
+
+	std::vector<Scope<ArenaAllocator>> m_frames;
+	uint32 m_currentFrame{ 0 };
+
+};
+
+template <typename T>
+using FrameVector = std::vector<T, StlAllocator<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, StlAllocator<char>>;
\ No newline at end of file
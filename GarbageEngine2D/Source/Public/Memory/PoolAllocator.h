@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Memory/Allocator.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Allocates blocks of fixed size classes from pages, freed blocks go to an intrusive free list of their class.
+// Requests that don't fit into the biggest class go straight to the heap
+class GARBAGE_API PoolAllocator final : public Allocator
+{
+public:
+
+	struct Specification
+	{
+		uint64 PageSize{ 64 * 1024 };
+		bool ThreadSafe{ true };
+		// Every thread keeps a few free blocks of each class, so most allocations don't touch the shared lists.
+		// A thread returns its cached blocks when it exits
+		bool ThreadLocalCaches{ false };
+	};
+
+	static constexpr uint32 NumberOfSizeClasses = 20;
+	static constexpr std::array<uint32, NumberOfSizeClasses> SizeClasses =
+	{
+		16, 32, 48, 64, 80, 96, 112, 128,
+		160, 192, 224, 256, 320, 384, 448, 512,
+		640, 768, 896, 1024
+	};
+	static constexpr uint64 MaxBlockSize = 1024;
+	static constexpr uint64 PageAlignment = 64;
+
+	PoolAllocator() : PoolAllocator(Specification()) {}
+	PoolAllocator(const Specification& specification);
+	~PoolAllocator();
+
+	void* Allocate(uint64 size, uint64 alignment = alignof(std::max_align_t)) override;
+	// Size and alignment must be the same as the ones passed to Allocate
+	void Deallocate(void* pointer, uint64 size, uint64 alignment = alignof(std::max_align_t)) override;
+
+	// Pools have no single allocation point, returns the number of bytes reserved in pages
+	uint64 Current() const override;
+	// Bytes taken by blocks that are in use, rounded up to their size classes
+	uint64 Length() const override;
+
+	// Makes sure there are free blocks for allocations of the given size
+	void Reserve(uint64 size) override;
+
+	uint64 GetPeakBytesInUse() const { return m_peakBytesInUse.load(std::memory_order_relaxed); }
+	uint64 GetNumberOfPages() const;
+
+	const Specification& GetSpecification() const { return m_specification; }
+
+	NON_COPYABLE(PoolAllocator)
+
+private:
+
+	static constexpr uint8 LargeAllocation = 0xFF;
+	static constexpr uint32 MaxThreadCaches = 8;
+	static constexpr uint32 ThreadCacheBatchSize = 32;
+
+	struct FreeBlock
+	{
+		FreeBlock* Next;
+	};
+
+	struct ThreadCache
+	{
+		uint64 PoolId;
+		FreeBlock* Blocks[NumberOfSizeClasses];
+		uint32 Counts[NumberOfSizeClasses];
+	};
+
+	struct ThreadCaches;
+
+	Specification m_specification;
+	uint64 m_id;
+
+	FreeBlock* m_freeLists[NumberOfSizeClasses]{};
+	std::vector<void*> m_pages;
+	mutable std::mutex m_mutex;
+
+	std::atomic<uint64> m_bytesInUse{ 0 };
+	std::atomic<uint64> m_peakBytesInUse{ 0 };
+
+	static uint8 GetSizeClass(uint64 size, uint64 alignment);
+
+	std::unique_lock<std::mutex> Lock() const;
+
+	// Must be called with the lock held
+	FreeBlock* PopFreeBlock(uint8 sizeClass);
+	void AllocatePage(uint8 sizeClass);
+
+	ThreadCache* FindThreadCache() const;
+	void RefillThreadCache(ThreadCache& cache, uint8 sizeClass);
+	void FlushThreadCache(ThreadCache& cache, uint8 sizeClass, uint32 count);
+
+};
\ No newline at end of file
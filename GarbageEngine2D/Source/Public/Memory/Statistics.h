@@ -1,21 +1,169 @@
 #pragma once
 
 #include "Core/Base.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+enum class MemoryDomain : uint8
+{
+	CPU, GPU,
+
+	Count
+};
+
+enum class MemoryCategory : uint8
+{
+	Textures, VertexBuffers, IndexBuffers, Framebuffers, Assets, Reflection, Allocators, Other,
+
+	Count
+};
+
+GARBAGE_API const char* MemoryDomainToString(MemoryDomain domain);
+GARBAGE_API const char* MemoryCategoryToString(MemoryCategory category);
+
+#if !defined(GARBAGE_SHIPPING)
+#define GARBAGE_TRACK_ALLOCATION_SITES 1
+#else
+#define GARBAGE_TRACK_ALLOCATION_SITES 0
+#endif
+
+#if GARBAGE_TRACK_ALLOCATION_SITES
+// Allocates from an engine allocator and remembers the call site while tagging is enabled
+#define GARBAGE_TAGGED_ALLOCATE(allocator, size, alignment) \
+	[&](uint64 taggedSize) { return MemoryStatistics::TagAllocation((allocator)->Allocate(taggedSize, alignment), taggedSize, __FILE__, __LINE__); }(size)
+#define GARBAGE_TAGGED_DEALLOCATE(allocator, pointer, size, alignment) \
+	do { MemoryStatistics::UntagAllocation(pointer); (allocator)->Deallocate(pointer, size, alignment); } while (0)
+#else
+#define GARBAGE_TAGGED_ALLOCATE(allocator, size, alignment) (allocator)->Allocate(size, alignment)
+#define GARBAGE_TAGGED_DEALLOCATE(allocator, pointer, size, alignment) (allocator)->Deallocate(pointer, size, alignment)
+#endif
 
 class GARBAGE_API MemoryStatistics
 {
 public:
 
-	static uint64 GetVRamUsedForTextures() { return Get().m_vramUsedForTextures; }
+	struct Counter
+	{
+		uint64 Current{ 0 };
+		// High-water mark since start or the last ResetPeaks
+		uint64 Peak{ 0 };
+		uint64 NumberOfAllocations{ 0 };
+	};
+
+	struct Snapshot
+	{
+		uint64 FrameIndex{ 0 };
+		Counter Counters[(uint8)MemoryDomain::Count][(uint8)MemoryCategory::Count];
+
+		const Counter& Get(MemoryDomain domain, MemoryCategory category) const { return Counters[(uint8)domain][(uint8)category]; }
+		uint64 GetTotal(MemoryDomain domain) const;
+	};
+
+	struct AllocationSite
+	{
+		const char* File;
+		uint32 Line;
+		uint64 Bytes;
+		uint64 NumberOfAllocations;
+	};
+
+	static constexpr uint64 MaxFrameHistory = 240;
+
+	static void Allocated(MemoryDomain domain, MemoryCategory category, uint64 size);
+	static void Freed(MemoryDomain domain, MemoryCategory category, uint64 size);
+	// Replaces a previously reported size, like when a buffer is resized. Zero sizes mean there is no allocation
+	static void Resized(MemoryDomain domain, MemoryCategory category, uint64 oldSize, uint64 newSize);
+
+	static Counter GetCounter(MemoryDomain domain, MemoryCategory category);
+	static uint64 GetTotal(MemoryDomain domain);
+	static uint64 GetVRamUsedForTextures() { return GetCounter(MemoryDomain::GPU, MemoryCategory::Textures).Current; }
+
+	static void ResetPeaks();
+
+	static Snapshot TakeSnapshot();
+	// Stores a snapshot in the frame history, called once per frame by the renderer
+	static void CaptureFrame();
+	// Index 0 is the oldest frame in the history
+	static uint64 GetNumberOfCapturedFrames();
+	static Snapshot GetCapturedFrame(uint64 index);
+
+	// Call-site tagging is off by default, every tagged allocation costs a map insertion
+	static void SetTaggingEnabled(bool enabled);
+	static bool IsTaggingEnabled() { return Get().m_taggingEnabled.load(std::memory_order_relaxed); }
+
+	static void* TagAllocation(void* pointer, uint64 size, const char* file, uint32 line);
+	static void UntagAllocation(const void* pointer);
+	// Used by allocators that release memory all at once
+	static void UntagRange(const void* begin, const void* end);
+
+	// Tagged allocations that are still alive, grouped by call site and sorted by size
+	static std::vector<AllocationSite> GetLiveAllocationSites();
+	static void LogLiveAllocationSites(uint64 maxSites = 16);
 
 private:
 
-	uint64 m_vramUsedForTextures;
+	struct AtomicCounter
+	{
+		std::atomic<uint64> Current{ 0 };
+		std::atomic<uint64> Peak{ 0 };
+		std::atomic<uint64> NumberOfAllocations{ 0 };
+	};
+
+	struct TaggedAllocation
+	{
+		uint64 Size;
+		const char* File;
+		uint32 Line;
+	};
+
+	AtomicCounter m_counters[(uint8)MemoryDomain::Count][(uint8)MemoryCategory::Count];
+
+	std::mutex m_historyMutex;
+	std::vector<Snapshot> m_history;
+	uint64 m_historyStart{ 0 };
+	uint64 m_frameIndex{ 0 };
+
+	std::atomic<bool> m_taggingEnabled{ false };
+	std::mutex m_tagsMutex;
+	std::map<const void*, TaggedAllocation> m_tags;
 
 	MemoryStatistics() = default;
 
 	static MemoryStatistics& Get();
 
-	friend class Texture;
+	static AtomicCounter& GetAtomicCounter(MemoryDomain domain, MemoryCategory category) { return Get().m_counters[(uint8)domain][(uint8)category]; }
+
+};
+
+// Reports a block of memory for as long as it lives. Lets reflected classes, whose destructor is generated, release their bytes
+class TrackedMemory final
+{
+public:
+
+	TrackedMemory(MemoryDomain domain, MemoryCategory category) : m_domain(domain), m_category(category) {}
+	TrackedMemory(const TrackedMemory& other) : m_domain(other.m_domain), m_category(other.m_category) { Set(other.m_size); }
+	~TrackedMemory() { Set(0); }
+
+	TrackedMemory& operator=(const TrackedMemory& other)
+	{
+		if (this != &other) Set(other.m_size);
+		return *this;
+	}
+
+	void Set(uint64 size)
+	{
+		MemoryStatistics::Resized(m_domain, m_category, m_size, size);
+		m_size = size;
+	}
+
+	uint64 Get() const { return m_size; }
+
+private:
+
+	MemoryDomain m_domain;
+	MemoryCategory m_category;
+	uint64 m_size{ 0 };
 
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Memory/Allocator.h"
+#include <cstddef>
+
+// Lets standard containers allocate from an engine allocator. Memory is never given back one by one,
+// so it is meant for allocators that release everything at once, like arenas and frame allocators
+template <typename T>
+class StlAllocator
+{
+public:
+
+	using value_type = T;
+
+	StlAllocator(Allocator& allocator) noexcept : m_allocator(&allocator) {}
+
+	template <typename U>
+	StlAllocator(const StlAllocator<U>& other) noexcept : m_allocator(other.GetAllocator()) {}
+
+	T* allocate(std::size_t count)
+	{
+		return (T*)m_allocator->Allocate(count * sizeof(T), alignof(T));
+	}
+
+	void deallocate(T* pointer, std::size_t count) noexcept {}
+
+	Allocator* GetAllocator() const noexcept { return m_allocator; }
+
+	template <typename U>
+	bool operator==(const StlAllocator<U>& other) const noexcept { return m_allocator == other.GetAllocator(); }
+
+	template <typename U>
+	bool operator!=(const StlAllocator<U>& other) const noexcept { return m_allocator != other.GetAllocator(); }
+
+private:
+
+	Allocator* m_allocator;
+
+};
\ No newline at end of file
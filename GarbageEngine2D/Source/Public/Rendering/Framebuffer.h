@@ -61,4 +61,6 @@ private:
 	std::vector<uint32> m_colorAttachments;
 	uint32 m_depthAttachment{ 0 };
 
+	uint64 m_sizeInVRam{ 0 };
+
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Core/Base.h"
+#include <string_view>
+#include <vector>
+
+// Measures GPU time of render passes with timestamp queries. Every frame has its own set of queries
+// in a small ring, results are read a few frames later when they are available, so reading never stalls
+class GARBAGE_API GpuTimer
+{
+public:
+
+	// Results are reported FramesInFlight - 1 frames late
+	static constexpr uint32 FramesInFlight = 4;
+	static constexpr uint32 MaxScopesPerFrame = 128;
+	static constexpr uint32 InvalidScope = 0xFFFFFFFF;
+
+	struct PassTime
+	{
+		// Scopes with the same name are summed
+		std::string_view Name;
+		float Milliseconds{ 0.0f };
+		uint32 Count{ 0 };
+	};
+
+	// Needs a current OpenGL context, does nothing if timer queries are not supported
+	static void Init();
+	static void Shutdown();
+	static bool IsSupported();
+
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	// Reads results of the oldest frame in the ring
+	static void BeginFrame();
+	// Closes scopes that are still open. Call it before swapping buffers, so waiting for vsync isn't measured
+	static void EndFrame();
+
+	// Name must outlive the frame. Returns InvalidScope when disabled or when the frame is out of scopes
+	static uint32 BeginScope(const char* name);
+	static void EndScope(uint32 scope);
+
+	// Results of the last frame whose queries finished
+	static const std::vector<PassTime>& GetPassTimes();
+	static float GetFrameMilliseconds();
+	// Frames whose results were not ready when their queries had to be reused
+	static uint64 GetNumberOfDroppedFrames();
+
+};
\ No newline at end of file
@@ -5,10 +5,14 @@
 #include "Rendering/VertexBuffer.h"
 #include "Rendering/VertexArray.h"
 #include "Rendering/Shader.h"
+#include "Math/Vector2.h"
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
+#include "Math/Random.h"
+#include <atomic>
 
 class ParticleSystemProxy;
+class ParticleWorld;
 
 class GARBAGE_API ParticleSystem
 {
@@ -38,35 +42,72 @@ public:
 
 		SimulationSpace SimulationSpace = SimulationSpace::Local;
 		uint64 StartCapacity = 200;
+
+		// Seed of particle random streams, 0 picks a unique one in order of creation
+		uint32 Seed = 0;
 	};
 
+	// Particles are simulated in fixed-size chunks, every chunk has its own random stream
+	static constexpr uint64 ChunkSize = 4096;
+
 	ParticleSystem(const Specification& specification, Vector3 worldPosition = Vector3(0.0f));
 	ParticleSystem(const ParticleSystem& other) : ParticleSystem(other.m_specification) {}
 
 	void Tick(float deltaTime);
 
+	uint64 GetNumberOfChunks() const { return (m_particles.Count + ChunkSize - 1) / ChunkSize; }
+	uint32 GetSeed() const { return m_seed; }
+
+	// Curves modified through it are baked again at the start of the next tick
+	Specification& GetSpecification() { return m_specification; }
+
 	void SetProxy(ParticleSystemProxy* proxy);
 	ParticleSystemProxy* GetProxy();
 
 private:
 	
 	friend class ParticleSystemProxy;
+	friend class ParticleWorld;
 
 	Specification m_specification;
 	ParticleSystemProxy* m_proxy{ nullptr };
 
-	struct Particle
+	uint32 m_seed;
+	uint64 m_tickIndex{ 0 };
+
+	// Every particle attribute is a separate stream, alive particles are always packed at the front.
+	// Dead particles are swap-removed, so the order of particles changes between ticks
+	struct ParticleStreams
 	{
-		Vector3 Velocity;
-		Vector3 Position;
-		Color Color;
-		float LifeTime;
-		float StartLifeTime;
-		float Size;
-		bool IsAlive{ true };
+		std::vector<float> PositionX;
+		std::vector<float> PositionY;
+		std::vector<float> PositionZ;
+		std::vector<float> VelocityX;
+		std::vector<float> VelocityY;
+		std::vector<float> VelocityZ;
+		std::vector<float> LifeTime;
+		std::vector<float> StartLifeTime;
+		std::vector<float> Size;
+		// Packed RGBA8, the same layout the GPU reads
+		std::vector<uint32> Colors;
+
+		uint64 Count{ 0 };
+
+		void Resize(uint64 capacity);
+		void Move(uint64 from, uint64 to);
 	};
 
-	std::vector<Particle> m_particles;
+	ParticleStreams m_particles;
+
+	// Chunks never touch particles of each other, so they can be simulated on different threads
+	void TickChunk(uint64 chunkIndex, float deltaTime);
+	Random GetChunkRandom(uint64 chunkIndex) const;
+
+	void SpawnParticle(uint64 index, const Random& random, const Vector3& additivePosition);
+	void IntegrateParticles(uint64 begin, uint64 end, float deltaTime);
+	void EvaluateParticleCurves(uint64 begin, uint64 end);
+	// Before chunks are ticked, they only read the baked tables
+	void BakeCurves();
 
 };
 
@@ -77,10 +118,17 @@ public:
 	ParticleSystemProxy(const ParticleSystem& particleSystem);
 	ParticleSystemProxy(const ParticleSystemProxy& other) : ParticleSystemProxy(other.m_particleSystem) { /* Do nothing */ }
 
+	// Called from the simulation thread, publishes a new snapshot without waiting for the render thread
 	void CopyData(const ParticleSystem& particleSystem);
 	void CopyData();
+	// Called from the render thread, uploads the latest published snapshot if there is a new one
 	void Draw(const Shader& shader);
 
+	// Snapshots that were replaced by a newer one before the render thread got to them
+	uint64 GetNumberOfDroppedSnapshots() const { return m_droppedSnapshots.load(std::memory_order_relaxed); }
+	// Draws that had no new snapshot and reused the data already on the GPU
+	uint64 GetNumberOfReusedSnapshots() const { return m_reusedSnapshots.load(std::memory_order_relaxed); }
+
 private:
 
 	ParticleSystem& m_particleSystem;
@@ -90,13 +138,25 @@ private:
 	Scope<VertexBuffer> m_colorsBuffer{ nullptr };
 	Scope<VertexArray> m_vertexArray{ new VertexArray() };
 
-	std::vector<Vector4> m_positionsSizes;
-	std::vector<Color> m_colors;
+	struct Snapshot
+	{
+		std::vector<Vector4> PositionsSizes;
+		std::vector<uint32> Colors;
+	};
 
-	bool m_dataWasUpdated{ false };
+	// Triple buffer: the simulation thread owns the write snapshot, the render thread owns the read one
+	// and the third one is the latest published snapshot, which they exchange atomically
+	static constexpr uint32 SnapshotIndexMask = 0x3;
+	static constexpr uint32 FreshSnapshotBit = 0x4;
 
-	Vector3 m_worldPosition{ 0.0f };
+	Snapshot m_snapshots[3];
+	// XY of particles for the batch transform, owned by the simulation thread
+	std::vector<Vector2> m_planarPositions;
+	uint32 m_writeSnapshot{ 0 };
+	uint32 m_readSnapshot{ 2 };
+	std::atomic<uint32> m_publishedSnapshot{ 1 };
 
-	std::mutex m_copyDataMutex;
+	std::atomic<uint64> m_droppedSnapshots{ 0 };
+	std::atomic<uint64> m_reusedSnapshots{ 0 };
 
 };
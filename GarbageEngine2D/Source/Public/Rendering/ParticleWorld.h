@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Rendering/ParticleSystem.h"
+#include <vector>
+
+// Owns particle systems and simulates them on the job system.
+// Large systems are split into chunks, results do not depend on the number of threads
+class GARBAGE_API ParticleWorld
+{
+public:
+
+	ParticleWorld() = default;
+
+	ParticleSystem* AddSystem(const ParticleSystem::Specification& specification, Vector3 worldPosition = Vector3(0.0f));
+	void RemoveSystem(ParticleSystem* particleSystem);
+
+	void Tick(float deltaTime);
+	// Copies data of every system to its proxy, if there is one
+	void CopyData();
+
+	uint64 GetNumberOfSystems() const { return m_systems.size(); }
+	ParticleSystem* GetSystem(uint64 index) const { return m_systems[index].get(); }
+
+	NON_COPYABLE(ParticleWorld)
+
+private:
+
+	struct ChunkItem
+	{
+		ParticleSystem* System;
+		uint64 ChunkIndex;
+	};
+
+	std::vector<Scope<ParticleSystem>> m_systems;
+	std::vector<ChunkItem> m_chunkItems;
+
+};
\ No newline at end of file
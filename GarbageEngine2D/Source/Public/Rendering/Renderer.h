@@ -7,7 +7,12 @@
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
 #include "Math/Matrix4.h"
+#include "Math/Transform2D.h"
 #include "Rendering/Texture.h"
+#include "Memory/FrameAllocator.h"
+
+struct TextureAtlasRegion;
+struct QuadCommand;
 
 class GARBAGE_API Renderer
 {
@@ -28,6 +33,13 @@ public:
 		ClockWise, CounterClockWise
 	};
 
+	// Vertices mode writes four full vertices per quad, Instanced mode writes one 40 byte record
+	// per quad and lets the vertex shader expand it
+	enum class QuadRenderingMode
+	{
+		Vertices, Instanced
+	};
+
 	enum class DepthFunction
 	{
 		LessOrEqual, Less, Equal, Greater, GreaterOrEqual, NotEqual, Always, Never
@@ -37,8 +49,18 @@ public:
 	{
 		uint32 DrawCalls{ 0 };
 		uint32 TotalNumberOfVertices{ 0 };
+		// CPU time between BeginNewFrame and EndFrame
 		float FrameTime{ 0.0f };
+		// CPU time spent sorting and submitting recorded quads
+		float SubmissionTime{ 0.0f };
+		// GPU time between BeginNewFrame and EndFrame, it is GpuTimer::FramesInFlight - 1 frames old
+		float GpuTime{ 0.0f };
 		uint64 QuadCount{ 0 };
+		// Number of times the renderer had to wait for GPU to release a region of the quad vertex stream
+		uint32 VertexStreamStalls{ 0 };
+		uint32 Flushes{ 0 };
+		uint32 TextureBinds{ 0 };
+		uint64 UploadedBytes{ 0 };
 
 		void Reset()
 		{
@@ -46,14 +68,38 @@ public:
 			TotalNumberOfVertices = 0;
 
 			FrameTime = 0.0f;
+			SubmissionTime = 0.0f;
+			GpuTime = 0.0f;
 
 			QuadCount = 0;
+			VertexStreamStalls = 0;
+
+			Flushes = 0;
+			TextureBinds = 0;
+			UploadedBytes = 0;
 		}
 
 		float GetFrameTimeSeconds() const { return FrameTime / 1000.0f; }
 		float GetFrameTimeMilliseconds() const { return FrameTime; }
 	};
 
+	enum class FrameMetric
+	{
+		FrameTime, SubmissionTime, GpuTime, DrawCalls, QuadCount, VertexStreamStalls, Flushes, TextureBinds, UploadedBytes
+	};
+
+	struct FrameSummary
+	{
+		float Min{ 0.0f };
+		float Average{ 0.0f };
+		float P95{ 0.0f };
+		float P99{ 0.0f };
+		float Max{ 0.0f };
+	};
+
+	// Number of finished frames kept in the history
+	static constexpr uint32 FrameHistorySize = 300;
+
 	Renderer() = default;
 
 	void Init();
@@ -65,11 +111,31 @@ public:
 	void BeginNewFrame(const Matrix4& projection, const Matrix4& view);
 	void EndFrame();
 
+	// Draws the recorded quads. Called by EndFrame and before every state or render target change,
+	// so quads are sorted only among the ones recorded since the last change
+	static void Flush();
+
 	void DrawVertexArray(const VertexArray& vertexArray);
 	void DrawVertexArray(const VertexArray& vertexArray, const IndexBuffer& indexBuffer);
 	void DrawVertexArray(const VertexArray& vertexArray, const IndexBuffer& indexBuffer, uint64 count);
 
+	// Quads are not drawn immediately, they are recorded and drawn on the next Flush sorted by layer, blend mode, texture and depth.
+	// Submission order is kept only between quads with equal sort keys, use layers to force the order
 	void DrawQuad(const Matrix4& transform, const Color& color = Color::White, const Texture2D* texture = nullptr, float tiling = 1.0f);
+	// Quads drawn from the same atlas page share a single texture bind. Tiling is not supported for atlas regions
+	void DrawQuad(const Matrix4& transform, const TextureAtlasRegion& region, const Color& color = Color::White);
+	// 2D overloads skip the 4x4 math, their quads have depth 0
+	void DrawQuad(const Transform2D& transform, const Color& color = Color::White, const Texture2D* texture = nullptr, float tiling = 1.0f);
+	void DrawQuad(const Transform2D& transform, const TextureAtlasRegion& region, const Color& color = Color::White);
+	// Rotation is in radians around the quad center
+	void DrawQuad(Vector2 position, Vector2 size, float rotation, const Color& color = Color::White, const Texture2D* texture = nullptr, float tiling = 1.0f);
+
+	void SetLayer(uint8 layer);
+	uint8 GetLayer() const;
+
+	// Takes effect on the next Flush
+	void SetQuadRenderingMode(QuadRenderingMode mode);
+	QuadRenderingMode GetQuadRenderingMode() const;
 
 	void EnableFeature(Feature feature);
 	void DisableFeature(Feature feature);
@@ -81,6 +147,16 @@ public:
 
 	const Statistics& GetStatistics() const;
 
+	uint32 GetNumberOfRecordedFrames() const;
+	// 0 is the last finished frame
+	const Statistics& GetRecordedFrame(uint32 framesAgo) const;
+	// Summary over all recorded frames
+	FrameSummary GetFrameSummary(FrameMetric metric) const;
+	void ClearFrameHistory();
+
+	// Memory for data that is needed only for the current frame, it stays valid for as many frames as the GPU can be behind
+	FrameAllocator& GetFrameAllocator() { return m_frameAllocator; }
+
 	int32 GetNumberOfSupportedVertexAttributes() const { return m_numberOfSupportedVertexAttributes; }
 	int32 GetMaxTextureSize() const { return m_maxTextureSize; }
 	int32 GetNumberOfTextureUnits() const { return m_numberOfTextureUnits; }
@@ -92,9 +168,15 @@ private:
 	int32 m_numberOfSupportedVertexAttributes;
 	int32 m_maxTextureSize;
 	int32 m_numberOfTextureUnits;
+
+	FrameAllocator m_frameAllocator;
 	
-	void StartBatch();
-	void FlushBatch();
-	void NextBatch();
+	static void StartBatch();
+	static void FlushBatch();
+	static void NextBatch();
+
+	void RecordQuad(const QuadCommand& command, float depth);
+	static uint32 FindOrAddTextureSlot(const Texture2D* texture);
+	static void SubmitQuadCommands();
 
 };
\ No newline at end of file
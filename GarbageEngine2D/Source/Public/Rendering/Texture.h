@@ -59,6 +59,7 @@ public:
 	uint32 GetWidth() const { return m_width; }
 	uint32 GetHeight() const { return m_height; }
 	Format GetFormat() const { return m_format; }
+	uint32 GetInternalId() const { return m_id; }
 
 	bool operator==(const Texture& other) const;
 
@@ -95,5 +96,7 @@ public:
 	Texture2D(const Specification& specification);
 
 	void SetData(void* data, uint32 size) override;
+	// Data must have the same format as the texture
+	void SetSubData(uint16 x, uint16 y, uint16 width, uint16 height, const void* data);
 
 };
\ No newline at end of file
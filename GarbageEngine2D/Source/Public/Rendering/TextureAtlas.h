@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Core/Base.h"
+#include "Math/Vector2.h"
+#include "Rendering/Texture.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+class Texture2DAsset;
+class TextureAtlasAsset;
+
+// Bottom-left skyline rectangle packer
+class GARBAGE_API SkylinePacker
+{
+public:
+
+	SkylinePacker(uint16 width, uint16 height);
+
+	// Returns false if there is no free space left for the rectangle
+	bool Pack(uint16 width, uint16 height, uint16& outX, uint16& outY);
+	void Clear();
+
+	uint16 GetWidth() const { return m_width; }
+	uint16 GetHeight() const { return m_height; }
+	float GetOccupancy() const { return (float)m_usedArea / ((float)m_width * (float)m_height); }
+
+private:
+
+	struct Node
+	{
+		uint16 X;
+		uint16 Y;
+		uint16 Width;
+	};
+
+	uint16 m_width;
+	uint16 m_height;
+	uint64 m_usedArea{ 0 };
+
+	std::vector<Node> m_skyline;
+
+	bool Fits(uint64 index, uint16 width, uint16 height, uint16& outY) const;
+
+};
+
+struct GARBAGE_API TextureAtlasRegion
+{
+	const Texture2D* Texture{ nullptr };
+	Vector2 UVMin{ 0.0f, 0.0f };
+	Vector2 UVMax{ 1.0f, 1.0f };
+};
+
+// Packs small textures into large RGBA8 pages, so quads using them can be drawn with a single texture bind.
+// Regions are never removed, rebuild the atlas when its contents change a lot
+class GARBAGE_API TextureAtlas
+{
+public:
+
+	struct Specification
+	{
+		uint16 PageSize{ 2048 };
+		// Borders of every region are extruded into the padding to avoid bleeding with linear filtering
+		uint16 Padding{ 1 };
+		// Bigger textures are rejected, they should be drawn on their own
+		uint16 MaxRegionSize{ 512 };
+		Texture::Filtering Filtering{ Texture::Filtering::Linear };
+	};
+
+	TextureAtlas() : TextureAtlas(Specification()) {}
+	TextureAtlas(const Specification& specification);
+	TextureAtlas(const TextureAtlasAsset& asset);
+
+	// Returns nullptr if the texture is too big for the atlas
+	const TextureAtlasRegion* Add(std::string_view name, const Texture2DAsset& texture);
+	const TextureAtlasRegion* Add(std::string_view name, const uint8* data, uint16 width, uint16 height, uint8 numberOfColorChannels);
+
+	const TextureAtlasRegion* Find(std::string_view name) const;
+
+	uint64 GetNumberOfPages() const { return m_pages.size(); }
+	const Texture2D* GetPage(uint64 index) const { return m_pages[index].Texture.get(); }
+	const Specification& GetSpecification() const { return m_specification; }
+
+	// Copies the image into a RGBA8 page at (x + padding, y + padding) and extrudes its border into the padding
+	static void CopyToPage(uint8* page, uint16 pageWidth, uint16 x, uint16 y, uint16 padding,
+		const uint8* data, uint16 width, uint16 height, uint8 numberOfColorChannels);
+
+	NON_COPYABLE(TextureAtlas)
+
+private:
+
+	struct Page
+	{
+		Ref<Texture2D> Texture;
+		SkylinePacker Packer;
+		bool Cooked{ false };
+	};
+
+	Specification m_specification;
+
+	std::vector<Page> m_pages;
+	std::unordered_map<std::string, TextureAtlasRegion> m_regions;
+
+	Page& AddPage(void* data = nullptr);
+
+};
\ No newline at end of file
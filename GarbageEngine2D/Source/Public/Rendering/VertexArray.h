@@ -11,7 +11,8 @@ public:
 	VertexArray();
 	~VertexArray();
 
-	void AddBuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout);
+	// Offset is the position of the first element in the buffer in bytes
+	void AddBuffer(const VertexBuffer& vertexBuffer, const VertexBufferLayout& layout, uint64 offset = 0);
 
 	void Bind() const;
 	FORCEINLINE uint32 GetNumberOfVertices() const { return m_count; }
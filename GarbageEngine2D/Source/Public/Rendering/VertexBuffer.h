@@ -16,16 +16,44 @@ public:
 	  *
 	  **/
 	VertexBuffer(const void* data, uint32 size, uint32 count, bool dynamic = false, bool instanced = false);
+
+	/**
+	  *   \brief Streaming vertex buffer. Storage is split into several regions that are written in rotation,
+	  *   every region is guarded by a fence, so CPU never writes to memory GPU still reads from
+	  *
+	  *   \param regionSize Size of one region in bytes
+	  *   \param count Number of vertices in one region
+	  *   \param numberOfRegions Number of regions in the ring
+	  *
+	  **/
+	VertexBuffer(uint32 regionSize, uint32 count, uint8 numberOfRegions, bool instanced = false);
 	~VertexBuffer();
 
 	void Bind() const;
 
 	void UpdateData(const void* data, uint32 size);
 
+	// Waits until GPU is done with the current region and maps it for writing
+	void* MapStreamRegion();
+	// Flushes first 'size' bytes of the mapped region and unmaps it
+	void UnmapStreamRegion(uint32 size);
+	// Inserts a fence after the draw that reads from the current region and moves to the next one
+	void AdvanceStreamRegion();
+
 	FORCEINLINE bool IsDynamic() const { return m_dynamic; }
 	FORCEINLINE bool IsInstanced() const { return m_instanced; }
+	FORCEINLINE bool IsStreaming() const { return m_numberOfStreamRegions > 0; }
 	FORCEINLINE uint32 GetCount() const { return m_count; }
 
+	// Index of the first vertex of the current region, to be used as base vertex when drawing
+	FORCEINLINE uint32 GetStreamRegionBaseVertex() const { return m_currentStreamRegion * m_count; }
+	FORCEINLINE uint8 GetCurrentStreamRegion() const { return m_currentStreamRegion; }
+	FORCEINLINE uint8 GetNumberOfStreamRegions() const { return m_numberOfStreamRegions; }
+	FORCEINLINE uint32 GetStreamRegionSize() const { return m_streamRegionSize; }
+	FORCEINLINE bool HasStalledOnLastMap() const { return m_stalledOnLastMap; }
+
+	NON_COPYABLE(VertexBuffer)
+
 private:
 
 	uint32 m_id{ 0 };
@@ -35,4 +63,10 @@ private:
 	bool m_dynamic = false;
 	bool m_instanced = false;
 
-};
\ No newline at end of file
+	uint8 m_numberOfStreamRegions{ 0 };
+	uint8 m_currentStreamRegion{ 0 };
+	uint32 m_streamRegionSize{ 0 };
+	Scope<void*[]> m_streamFences;
+	bool m_stalledOnLastMap{ false };
+
+};
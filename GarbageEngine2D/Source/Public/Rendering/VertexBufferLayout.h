@@ -6,6 +6,7 @@
 #include "Math/Vector3.h"
 #include "Math/Vector4.h"
 #include "Math/Matrix4.h"
+#include "Math/Half.h"
 #include <vector>
 
 struct GARBAGE_API VertexBufferElement final
@@ -54,6 +55,20 @@ struct GARBAGE_API VertexBufferLayout final
 		m_stride += sizeof(uint8) * count;
 	}
 
+	template <>
+	void Push<uint16>(uint32 count)
+	{
+		m_elements.push_back({ count, 0x1403, true });
+		m_stride += sizeof(uint16) * count;
+	}
+
+	template <>
+	void Push<Half>(uint32 count)
+	{
+		m_elements.push_back({ count, 0x140B, false });
+		m_stride += sizeof(Half) * count;
+	}
+
 	template <>
 	void Push<Vector2>(uint32 count)
 	{
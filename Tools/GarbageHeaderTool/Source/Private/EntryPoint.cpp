@@ -49,10 +49,11 @@ int main(int argc, char** argv)
 	std::wstring projectName;
 	std::wstring projectApi;
 	bool forceGenerate = false;
+	bool staticTables = false;
 
 	if (argc < 5)
 	{
-		std::cerr << "Usage: GarbageHeaderTool.exe -pPROJECT_NAME -aPROJECT_API -oOUT_PATH [-sSCAN_PATH]\n";
+		std::cerr << "Usage: GarbageHeaderTool.exe -pPROJECT_NAME -aPROJECT_API -oOUT_PATH [-sSCAN_PATH] [-force] [-static]\n";
 		return EXIT_FAILURE;
 	}
 
@@ -60,7 +61,9 @@ int main(int argc, char** argv)
 	{
 		std::string arg = argv[i];
 
-		if (arg.starts_with("-s")) pathsToScanFor_.push_back(arg.substr(2));
+		// Registers the project from read-only tables generated for every header, instead of building the registry step by step
+		if (arg == "-static") staticTables = true;
+		else if (arg.starts_with("-s")) pathsToScanFor_.push_back(arg.substr(2));
 		else if (arg.starts_with("-o")) pathToOutputGeneratedStuff = arg.substr(2);
 		else if (arg.starts_with("-p")) projectName = StringToWideString(arg.substr(2));
 		else if (arg.starts_with("-force")) forceGenerate = true;
@@ -144,7 +147,10 @@ int main(int argc, char** argv)
 						static uint64 length = std::wstring(L"#define CURRENT_FILE_ID ").length();
 
 						auto position = fileContent.find(L"#define CURRENT_FILE_ID ");
-						if (position != std::wstring::npos)
+						static std::wstring version = L"// Version " + std::to_wstring(GarbageHeaderTool::Parser::GeneratedCodeVersion) + L"\n";
+						bool sameVersion = fileContent.find(version) != std::wstring::npos;
+
+						if (position != std::wstring::npos && sameVersion)
 						{
 							auto fileId = fileContent.substr(position + length, 36);
 
@@ -204,6 +210,37 @@ int main(int argc, char** argv)
 	}
 	globalReflectionOut << L"\n";
 
+	if (staticTables)
+	{
+		for (auto& fileId : fileIds)
+		{
+			globalReflectionOut << L"\n_" << fileId << L"_REFLECTION_TABLES";
+		}
+
+		globalReflectionOut << L"\n\nnamespace " << projectName << L"Reflection\n{\n\n\tstatic constexpr Meta::EnumDescriptor s_enums[] =\n\t{";
+
+		for (auto& fileId : fileIds)
+		{
+			globalReflectionOut << L"\n\t\t_" << fileId << L"_ENUM_DESCRIPTORS";
+		}
+
+		globalReflectionOut << L"\n\t\t{ nullptr }\n\t};\n\n\tstatic constexpr Meta::TypeDescriptor s_types[] =\n\t{";
+
+		for (auto& fileId : fileIds)
+		{
+			globalReflectionOut << L"\n\t\t_" << fileId << L"_TYPE_DESCRIPTORS";
+		}
+
+		globalReflectionOut << L"\n\t\t{ nullptr }\n\t};\n\n\tvoid Register()\n\t{\n\t\tMeta::Registry& registry = Meta::Registry::Get();\n";
+		globalReflectionOut << L"\n\t\tregistry.AddEnums(s_enums);\n\t\tregistry.AddTypes(s_types);\n\t\tregistry.Freeze();\n\t}\n\n}\n";
+
+		globalReflectionOut.close();
+
+		std::wcout << "Generating reflection took " << timer.GetElapsedSeconds() << "s" << std::endl;
+
+		return 0;
+	}
+
 	globalReflectionOut << L"\nnamespace " << projectName << L"Reflection\n{\n\n\tvoid Register()\n\t{\n\t\tMeta::Registry & registry = Meta::Registry::Get(); \n\t";
 
 	for (auto& fileId : fileIds)
@@ -226,6 +263,8 @@ int main(int argc, char** argv)
 		globalReflectionOut << L"\n\t\t_" << fileId << L"_REGISTER_PROPERTIES(registry)";
 	}
 
+	globalReflectionOut << L"\n\n\t\tregistry.Freeze();";
+
 	globalReflectionOut << L"\n\t}\n\n}\n";
 
 	globalReflectionOut.close();
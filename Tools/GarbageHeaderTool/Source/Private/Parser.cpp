@@ -5,6 +5,7 @@
 #include <chrono>
 #include <iostream>
 #include <random>
+#include <unordered_set>
 #include <codecvt>
 #include <filesystem>
 
@@ -67,11 +68,11 @@ namespace Utils
 	}
 
 #ifndef USE_NEW_SYSTEM_THAT_DOESNT_SHIT_IN_INTELLISENSE
-#define SERIALIZE_TYPE_(type) if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << o->*(" << L## #type << L" ObjectBase::*)" << typeName << L"::Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"();"; }
-#define SERIALIZE_TYPE(type) else if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << o->*(" << L## #type << L" ObjectBase::*)" << typeName << L"::Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"();"; }
+#define SERIALIZE_TYPE_(type) if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << *(" << L## #type << L"*)((uint8*)o + " << typeName << L"::Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"().Offset);"; }
+#define SERIALIZE_TYPE(type) else if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << *(" << L## #type << L"*)((uint8*)o + " << typeName << L"::Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"().Offset);"; }
 #else
-#define SERIALIZE_TYPE_(type) if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << o->*(" << L## #type << L" ObjectBase::*)Z_" << typeName << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"();"; }
-#define SERIALIZE_TYPE(type) else if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << o->*(" << L## #type << L" ObjectBase::*)Z_" << typeName << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"();"; }
+#define SERIALIZE_TYPE_(type) if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << *(" << L## #type << L"*)((uint8*)o + Z_" << typeName << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"().Offset);"; }
+#define SERIALIZE_TYPE(type) else if (property.Type == L## #type) { out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << *(" << L## #type << L"*)((uint8*)o + Z_" << typeName << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"().Offset);"; }
 
 #endif
 
@@ -126,9 +127,9 @@ namespace Utils
 					if (property.Type == enumerator.Name)
 					{
 #ifndef USE_NEW_SYSTEM_THAT_DOESNT_SHIT_IN_INTELLISENSE
-						out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << std::string(\"" << enumerator.Name << "::\").append(registry.FindEnum(\"" << enumerator.Name << "\")->ValueToString((int64)(o->*(" << enumerator.Name << " ObjectBase::*)" << typeName << L"::Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"())));";
+						out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << std::string(\"" << enumerator.Name << "::\").append(Z_" << enumerator.Name << "_TO_STRING(*(" << enumerator.Name << "*)((uint8*)o + " << typeName << L"::Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"().Offset)));";
 #else
-						out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << std::string(\"" << enumerator.Name << "::\").append(registry.FindEnum(\"" << enumerator.Name << "\")->ValueToString((int64)(o->*(" << enumerator.Name << " ObjectBase::*)Z_" << typeName << "_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"())));";
+						out << "a << ArchiveManipulator::Key << \"" << property.Identifier << L"\" << ArchiveManipulator::Value << std::string(\"" << enumerator.Name << "::\").append(Z_" << enumerator.Name << "_TO_STRING(*(" << enumerator.Name << "*)((uint8*)o + Z_" << typeName << "_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"().Offset)));";
 #endif
 						break;
 					}
@@ -137,6 +138,113 @@ namespace Utils
 		}
 	}
 
+
+	// Emits the value arrays and the descriptor array of the decorators, returns the descriptor fields referencing them
+	std::wstring GenerateDecoratorTable(std::wostream& out, const std::vector<GarbageHeaderTool::Decorator>& decorators, const std::wstring& prefix)
+	{
+		if (decorators.empty()) return L"nullptr, 0";
+
+		for (uint64 i = 0; i < decorators.size(); i++)
+		{
+			if (decorators[i].Values.empty()) continue;
+
+			out << L" \\\nstatic constexpr const char* " << prefix << L"_DECORATOR_VALUES_" << i << L"[] = { ";
+
+			for (uint64 j = 0; j < decorators[i].Values.size(); j++)
+			{
+				if (j > 0) out << L", ";
+				out << L"\"" << decorators[i].Values[j] << L"\"";
+			}
+
+			out << L" };";
+		}
+
+		out << L" \\\nstatic constexpr Meta::DecoratorDescriptor " << prefix << L"_DECORATORS[] = { ";
+
+		for (uint64 i = 0; i < decorators.size(); i++)
+		{
+			if (i > 0) out << L", ";
+
+			auto& decorator = decorators[i];
+			out << L"{ \"" << decorator.Name << L"\", ";
+
+			if (decorator.Values.empty()) out << L"nullptr";
+			else out << prefix << L"_DECORATOR_VALUES_" << i;
+
+			out << L", " << decorator.Values.size() << L", GARBAGE_SID(\"" << decorator.Name << L"\") }";
+		}
+
+		out << L" };";
+
+		return prefix + L"_DECORATORS, " + std::to_wstring(decorators.size());
+	}
+
+	// Emits the tables of a class or struct into out and its descriptor into descriptors
+	void GenerateTypeTables(std::wostream& out, std::wostream& descriptors, std::wstring_view typeName, std::list<GarbageHeaderTool::GProperty>& properties,
+		const std::vector<GarbageHeaderTool::Decorator>& decorators, const std::vector<std::wstring>& parents, bool withSerializer,
+		std::wstring_view fileId, std::vector<GarbageHeaderTool::GEnum>& enums)
+	{
+		std::wstring prefix = L"Z_" + std::wstring(typeName) + L"_" + std::wstring(fileId);
+
+		if (!parents.empty())
+		{
+			out << L" \\\nstatic constexpr const char* " << prefix << L"_PARENTS[] = { ";
+
+			for (uint64 i = 0; i < parents.size(); i++)
+			{
+				if (i > 0) out << L", ";
+				out << L"\"" << parents[i] << L"\"";
+			}
+
+			out << L" };";
+		}
+
+		std::vector<std::wstring> propertyDecorators;
+		for (auto& property : properties)
+		{
+			propertyDecorators.push_back(GenerateDecoratorTable(out, property.Decorators, prefix + L"_" + property.Identifier));
+		}
+
+		if (!properties.empty())
+		{
+			out << L" \\\nstatic constexpr Meta::PropertyDescriptor " << prefix << L"_PROPERTIES[] = {";
+
+			uint64 i = 0;
+			for (auto& property : properties)
+			{
+				out << L" \\\n\t{ \"" << property.Identifier << L"\", \"" << property.Type << L"\", ";
+#ifndef USE_NEW_SYSTEM_THAT_DOESNT_SHIT_IN_INTELLISENSE
+				out << L"&" << typeName << L"::Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier;
+#else
+				out << L"&" << prefix << L"_GET_PROP_LAYOUT_" << property.Identifier;
+#endif
+				out << L", " << propertyDecorators[i++] << L", GARBAGE_SID(\"" << property.Identifier << L"\") },";
+			}
+
+			out << L" \\\n};";
+		}
+
+		std::wstring typeDecorators = GenerateDecoratorTable(out, decorators, prefix);
+
+		if (withSerializer && !properties.empty())
+		{
+			out << L" \\\nstatic void " << prefix << L"_SERIALIZE(Archive& a, ObjectBase* o_) \\\n{";
+			out << L" \\\n\t\t" << typeName << "* o = (" << typeName << "*)o_;";
+			out << L" \\\n\t\t a << ArchiveManipulator::BeginMap;";
+
+			GenerateSerializer(out, properties, fileId, typeName, enums);
+
+			out << L" \\\n\t\t a << ArchiveManipulator::EndMap;";
+			out << L" \\\n}";
+		}
+
+		descriptors << L" \\\n\t{ \"" << typeName << L"\", &Meta::Instantiate<" << typeName << L">, ";
+		descriptors << (withSerializer && !properties.empty() ? prefix + L"_SERIALIZE" : L"nullptr");
+		descriptors << L", sizeof(" << typeName << L"), alignof(" << typeName << L"), ";
+		descriptors << (parents.empty() ? L"nullptr" : prefix + L"_PARENTS") << L", " << parents.size() << L", ";
+		descriptors << (properties.empty() ? L"nullptr" : prefix + L"_PROPERTIES") << L", " << properties.size() << L", ";
+		descriptors << typeDecorators << L" },";
+	}
 }
 
 namespace GarbageHeaderTool
@@ -237,7 +345,7 @@ namespace GarbageHeaderTool
 		Utils::ReplaceAll(friendlyBaseFilename, L"\\", L"_");
 
 		std::time_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-		out << L"// Generated by Garbage Header Tool\n// " << std::ctime(&time) << L"\n\n";
+		out << L"// Generated by Garbage Header Tool\n// Version " << GeneratedCodeVersion << L"\n// " << std::ctime(&time) << L"\n\n";
 		out << L"#pragma once\n\n";
 		
 
@@ -273,7 +381,8 @@ namespace GarbageHeaderTool
 
 			if ($class.Properties.size() > 0)
 			{
-				out << L", [&registry](Archive& a, ObjectBase* o_) \\\n\t{";
+				// Captures nothing, so it converts to the plain function pointer the registry stores
+				out << L", [](Archive& a, ObjectBase* o_) \\\n\t{";
 
 				out << L" \\\n\t\t" << $class.Name << "* o = (" << $class.Name << "*)o_;";
 				out << L" \\\n\t\t a << ArchiveManipulator::BeginMap;";
@@ -284,7 +393,7 @@ namespace GarbageHeaderTool
 
 				out << L" \\\n\t}";
 			}
-			else out << L", {}";
+			else out << L", nullptr";
 
 			if ($class.Methods.size() > 0)
 			{
@@ -317,7 +426,7 @@ namespace GarbageHeaderTool
 						out << L"\"" << decorator.Values[j] << "\"";
 					}
 
-					out << L"} }";
+					out << L"}, GARBAGE_SID(\"" << decorator.Name << L"\") }";
 				}
 
 				out << L" }); \\\n";
@@ -331,7 +440,7 @@ namespace GarbageHeaderTool
 			if (structure.Decorators.empty()) out << L"); \\\n";
 			else
 			{
-				out << L", std::initializer_list<Meta::Decorator>{ ";
+				out << L", nullptr, std::initializer_list<Meta::Decorator>{ ";
 
 				for (uint8 i = 0; i < structure.Decorators.size(); i++)
 				{
@@ -346,7 +455,7 @@ namespace GarbageHeaderTool
 						out << L"\"" << decorator.Values[j] << "\"";
 					}
 
-					out << L"} }";
+					out << L"}, GARBAGE_SID(\"" << decorator.Name << L"\") }";
 				}
 
 				out << L" }); \\\n";
@@ -391,9 +500,9 @@ namespace GarbageHeaderTool
 				i++;
 
 #ifndef USE_NEW_SYSTEM_THAT_DOESNT_SHIT_IN_INTELLISENSE
-				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", " << $class.Name << L"::Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"()";
+				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", " << $class.Name << L"::Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"()";
 #else
-				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", Z_" << $class.Name << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"()";
+				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", Z_" << $class.Name << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"()";
 #endif
 
 				if (property.Decorators.empty()) out << L")";
@@ -414,7 +523,7 @@ namespace GarbageHeaderTool
 							out << L"\"" << decorator.Values[j] << "\"";
 						}
 
-						out << L"} }";
+						out << L"}, GARBAGE_SID(\"" << decorator.Name << L"\") }";
 					}
 
 					out << L" })";
@@ -438,9 +547,9 @@ namespace GarbageHeaderTool
 				i++;
 
 #ifndef USE_NEW_SYSTEM_THAT_DOESNT_SHIT_IN_INTELLISENSE
-				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", " << structure.Name << L"::Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"()";
+				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", " << structure.Name << L"::Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"()";
 #else
-				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", Z_" << structure.Name << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"()";
+				out << L"AddProperty(\"" << property.Identifier << L"\", \"" << property.Type << L"\", Z_" << structure.Name << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"()";
 #endif
 				if (property.Decorators.empty()) out << L")";
 				else
@@ -460,7 +569,7 @@ namespace GarbageHeaderTool
 							out << L"\"" << decorator.Values[j] << "\"";
 						}
 
-						out << L"} }";
+						out << L"}, GARBAGE_SID(\"" << decorator.Name << L"\") }";
 					}
 
 					out << L" })";
@@ -471,6 +580,52 @@ namespace GarbageHeaderTool
 		}
 		out << L"}\n\n";
 
+		// Read-only tables registering the module in a single pass, used by the global reflection file when the tool runs with -static
+		std::wstringstream typeDescriptors;
+		std::wstringstream enumDescriptors;
+
+		out << L"#define _" << fileId << "_REFLECTION_TABLES";
+		for (auto& $class : m_classes)
+		{
+			std::vector<std::wstring> parents;
+			for (auto& parent : $class.Parents)
+			{
+				if (!parent.empty() && parent != L"public" && parent != L"protected" && parent != L"private") parents.push_back(parent);
+			}
+
+			Utils::GenerateTypeTables(out, typeDescriptors, $class.Name, $class.Properties, $class.Decorators, parents, true, fileId, m_enums);
+		}
+
+		for (auto& structure : m_structs)
+		{
+			Utils::GenerateTypeTables(out, typeDescriptors, structure.Name, structure.Properties, structure.Decorators, {}, false, fileId, m_enums);
+		}
+
+		for (auto& enumerator : m_enums)
+		{
+			std::wstring values = L"nullptr";
+
+			if (!enumerator.Values.empty())
+			{
+				values = L"Z_" + enumerator.Name + L"_" + fileId + L"_VALUES";
+				out << L" \\\nstatic constexpr Meta::EnumValueDescriptor " << values << L"[] = { ";
+
+				for (uint64 i = 0; i < enumerator.Values.size(); i++)
+				{
+					if (i > 0) out << L", ";
+					out << L"{ \"" << enumerator.Values[i].Name << L"\", " << enumerator.Values[i].Value << L" }";
+				}
+
+				out << L" };";
+			}
+
+			enumDescriptors << L" \\\n\t{ \"" << enumerator.Name << L"\", " << values << L", " << enumerator.Values.size() << L" },";
+		}
+		out << L"\n\n";
+
+		out << L"#define _" << fileId << "_TYPE_DESCRIPTORS" << typeDescriptors.str() << L"\n\n";
+		out << L"#define _" << fileId << "_ENUM_DESCRIPTORS" << enumDescriptors.str() << L"\n\n";
+
 #ifdef USE_NEW_SYSTEM_THAT_DOESNT_SHIT_IN_INTELLISENSE
 		for (auto& $class : m_classes)
 		{
@@ -495,7 +650,7 @@ namespace GarbageHeaderTool
 
 			for (auto& property : $class.Properties)
 			{
-				out << L" \\\npublic: static void* ObjectBase::* Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"() { return (void* ObjectBase::*)&" << $class.Name << L"::" << property.Identifier << L"; }";
+				out << L" \\\npublic: static Meta::PropertyLayout Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"() { return Meta::MakePropertyLayout<decltype(" << $class.Name << L"::" << property.Identifier << L")>(offsetof(" << $class.Name << L", " << property.Identifier << L")); }";
 			}
 
 			out << L"\n\n";
@@ -511,7 +666,7 @@ namespace GarbageHeaderTool
 
 				for (auto& property : structure.Properties)
 				{
-					out << L" \\\npublic: static void* ObjectBase::* Z_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"() { return (void* ObjectBase::*)&" << structure.Name << L"::" << property.Identifier << L"; }";
+					out << L" \\\npublic: static Meta::PropertyLayout Z_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"() { return Meta::MakePropertyLayout<decltype(" << structure.Name << L"::" << property.Identifier << L")>(offsetof(" << structure.Name << L", " << property.Identifier << L")); }";
 				}
 
 				out << L"\n\n";
@@ -547,7 +702,7 @@ namespace GarbageHeaderTool
 
 			for (auto& property : $class.Properties)
 			{
-				out << L" \\\nfriend " << projectApi << L" void* ObjectBase::* Z_" << $class.Name << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"();"; // { return (void* ObjectBase::*)&" << $class.Name << L"::" << property.Identifier << L"; }";
+				out << L" \\\nfriend " << projectApi << L" Meta::PropertyLayout Z_" << $class.Name << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"();";
 			}
 
 			out << L"\n\n";
@@ -566,7 +721,7 @@ namespace GarbageHeaderTool
 
 				for (auto& property : structure.Properties)
 				{
-					out << L" \\\nfriend " << projectApi << L" void* ObjectBase::* Z_" << structure.Name << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"();"; // { return (void* ObjectBase::*)&" << $class.Name << L"::" << property.Identifier << L"; }";
+					out << L" \\\nfriend " << projectApi << L" Meta::PropertyLayout Z_" << structure.Name << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"();";
 				}
 
 				out << L" public:\n\n";
@@ -581,7 +736,7 @@ namespace GarbageHeaderTool
 
 				for (auto& property : structure.Properties)
 				{
-					out << L" \\\n" << projectApi << " void* ObjectBase::* Z_" << structure.Name << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"() { return (void* ObjectBase::*)&" << structure.Name << L"::" << property.Identifier << L"; }";
+					out << L" \\\n" << projectApi << " Meta::PropertyLayout Z_" << structure.Name << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"() { return Meta::MakePropertyLayout<decltype(" << structure.Name << L"::" << property.Identifier << L")>(offsetof(" << structure.Name << L", " << property.Identifier << L")); }";
 				}
 			}
 		}
@@ -596,7 +751,7 @@ namespace GarbageHeaderTool
 
 			for (auto& property : $class.Properties)
 			{
-				out << L" \\\n" << projectApi << " void* ObjectBase::* Z_" << $class.Name << L"_" << fileId << L"_GET_PROP_ADDRESS_" << property.Identifier << L"() { return (void* ObjectBase::*)&" << $class.Name << L"::" << property.Identifier << L"; }";
+				out << L" \\\n" << projectApi << " Meta::PropertyLayout Z_" << $class.Name << L"_" << fileId << L"_GET_PROP_LAYOUT_" << property.Identifier << L"() { return Meta::MakePropertyLayout<decltype(" << $class.Name << L"::" << property.Identifier << L")>(offsetof(" << $class.Name << L", " << property.Identifier << L")); }";
 			}
 		}
 #endif
@@ -611,6 +766,35 @@ namespace GarbageHeaderTool
 			}
 		}
 
+		// Switch based conversions, so serializers don't go through the registry
+		for (auto& enumerator : m_enums)
+		{
+			out << L" \\\nconstexpr std::string_view Z_" << enumerator.Name << L"_TO_STRING(" << enumerator.Name << L" value)";
+			out << L" \\\n{ \\\n\tswitch (value) \\\n\t{";
+
+			// Aliases would be duplicate case labels, the last name wins like in Meta::Enum
+			std::unordered_set<int64> values;
+			for (auto value = enumerator.Values.rbegin(); value != enumerator.Values.rend(); ++value)
+			{
+				if (!values.insert(value->Value).second) continue;
+
+				out << L" \\\n\t\tcase " << enumerator.Name << L"::" << value->Name << L": return \"" << value->Name << L"\";";
+			}
+
+			out << L" \\\n\t\tdefault: return \"Unknown\";";
+			out << L" \\\n\t} \\\n}";
+
+			out << L" \\\nconstexpr std::optional<" << enumerator.Name << L"> Z_" << enumerator.Name << L"_FROM_STRING(std::string_view name)";
+			out << L" \\\n{ \\\n\tswitch (StringId::Hash(name)) \\\n\t{";
+
+			for (auto& value : enumerator.Values)
+			{
+				out << L" \\\n\t\tcase StringId::Hash(\"" << value.Name << L"\"): if (name == \"" << value.Name << L"\") return " << enumerator.Name << L"::" << value.Name << L"; break;";
+			}
+
+			out << L" \\\n\t} \\\n\treturn std::nullopt; \\\n}";
+		}
+
 		return out.str();
 	}
 
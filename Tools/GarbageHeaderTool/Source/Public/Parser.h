@@ -89,6 +89,9 @@ namespace GarbageHeaderTool
 	{
 	public:
 
+		// Bumped when the generated code changes, headers generated by another version are regenerated
+		static constexpr uint32 GeneratedCodeVersion = 4;
+
 		Parser(std::vector<Token>& tokens, const std::filesystem::path& path) : m_tokens(tokens), m_path(path) {}
 
 
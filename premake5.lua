@@ -41,6 +41,11 @@ group "Core"
     include "GarbageEditor"
 group ""
 
+group "Benchmarks"
+    include "Benchmarks/MathBenchmark"
+    include "Benchmarks/ReflectionBenchmark"
+group ""
+
 group "Tools"
     include "Tools/GarbageHeaderTool"
 group ""
\ No newline at end of file